@@ -0,0 +1,87 @@
+#include "AiLodScheduler.h"
+#include "Player.h"
+#include <algorithm>
+
+void AiLodScheduler::Reset() {
+    pendingTime.clear();
+    deferred.clear();
+    tasks.clear();
+    candidates.clear();
+    stats = Stats();
+}
+
+void AiLodScheduler::Schedule(const std::vector<Monster>& monsters, const Player& player, float deltaTime) {
+    const size_t count = monsters.size();
+    if (pendingTime.size() != count) { // 怪物列表整体替换过
+        pendingTime.assign(count, 0.0f);
+        deferred.assign(count, 0);
+    }
+    ++frame;
+    tasks.clear();
+    candidates.clear();
+    stats = Stats();
+
+    const float midSq = settings.midDistance * settings.midDistance;
+    const float farSq = settings.farDistance * settings.farDistance;
+    const uint64_t midInterval = static_cast<uint64_t>(std::max(1, settings.midInterval));
+    const uint64_t farInterval = static_cast<uint64_t>(std::max(1, settings.farInterval));
+    for (size_t i = 0; i < count; ++i) {
+        const Monster& monster = monsters[i];
+        glm::vec2 offset = monster.position - player.position;
+        float distanceSq = offset.x * offset.x + offset.y * offset.y;
+        float nearRange = monster.detectionRange + settings.nearMargin;
+
+        Tier tier = distanceSq <= nearRange * nearRange ? TIER_NEAR
+                  : distanceSq <= midSq ? TIER_MID
+                  : distanceSq <= farSq ? TIER_FAR : TIER_SLEEP;
+        ++stats.inTier[tier];
+
+        if (tier == TIER_SLEEP) {
+            pendingTime[i] = 0.0f;
+            deferred[i] = 0;
+            continue;
+        }
+        float pending = std::min(pendingTime[i] + deltaTime, settings.maxAccumulated);
+        if (tier == TIER_NEAR) {
+            tasks.push_back({ static_cast<uint32_t>(i), pending, tier });
+            ++stats.updated[tier];
+            pendingTime[i] = 0.0f;
+            deferred[i] = 0;
+            continue;
+        }
+        pendingTime[i] = pending;
+        // 按下标错开，同一档的怪物不会挤在同一帧更新
+        uint64_t interval = tier == TIER_MID ? midInterval : farInterval;
+        if (deferred[i] || (frame + i) % interval == 0) {
+            candidates.push_back({ static_cast<uint32_t>(i), pending, tier });
+        }
+    }
+
+    // 上一帧被推迟的任务先执行，避免同一批怪物一直排在预算之外
+    std::stable_partition(candidates.begin(), candidates.end(), [&](const Task& task) { return deferred[task.monster] != 0; });
+    const double budget = settings.budgetMs * 1e-3;
+    double estimated = 0.0;
+    for (const Task& task : candidates) {
+        estimated += averageCost[task.tier];
+        // 至少执行一个，预算再小也能逐帧推进
+        if (budget > 0.0 && estimated > budget && stats.updated[TIER_MID] + stats.updated[TIER_FAR] > 0) {
+            deferred[task.monster] = 1;
+            ++stats.deferred;
+            continue;
+        }
+        tasks.push_back(task);
+        ++stats.updated[task.tier];
+        pendingTime[task.monster] = 0.0f;
+        deferred[task.monster] = 0;
+    }
+}
+
+void AiLodScheduler::ReportCost(double midSeconds, double farSeconds) {
+    // 指数滑动平均，避免个别慢帧让预算大幅抖动
+    if (stats.updated[TIER_MID] > 0) {
+        averageCost[TIER_MID] = averageCost[TIER_MID] * 0.9 + midSeconds / stats.updated[TIER_MID] * 0.1;
+    }
+    if (stats.updated[TIER_FAR] > 0) {
+        averageCost[TIER_FAR] = averageCost[TIER_FAR] * 0.9 + farSeconds / stats.updated[TIER_FAR] * 0.1;
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Monster.h"
+
+class Player;
+
+// AI LOD 参数 (距离单位为像素)
+struct AiLodSettings {
+    float nearMargin = 50.0f;     // 探测范围外再加这段距离仍按近处处理 (玩家走近时不会延迟一帧才开始追逐)
+    float midDistance = 800.0f;   // 超出近处、但在此距离内为中距离: 每 midInterval 帧完整更新一次
+    float farDistance = 2000.0f;  // 中距离之外、此距离之内为远处: 每 farInterval 帧做一次格子级粗略巡逻；再远则休眠
+    int midInterval = 4;
+    int farInterval = 30;
+    float maxStep = 0.1f;         // 累计的 deltaTime 按不超过 maxStep 的子步更新 (防止一步跨过墙)
+    float maxAccumulated = 1.0f;  // 累计时间的上限 (预算不足被推迟太久时丢弃多余的时间)
+    float budgetMs = 2.0f;        // 每帧中距离/远处更新的时间预算 (所有线程的 CPU 时间之和)，<= 0 表示不限
+};
+
+// AI LOD 调度器
+// 每帧按到玩家的距离把怪物分为近处 / 中距离 / 远处 / 休眠四档:
+// 近处每帧完整更新；中距离与远处错开帧降频更新，期间累计 deltaTime，轮到时一次补上；
+// 休眠的怪物不更新，也不累计时间，直到玩家走近。
+// 中距离与远处的更新受每帧时间预算限制 (按最近实测的平均单次耗时估算)，
+// 超出预算的怪物推迟到下一帧并优先处理；近处的怪物不受预算限制。
+class AiLodScheduler {
+public:
+    enum Tier : uint8_t { TIER_NEAR, TIER_MID, TIER_FAR, TIER_SLEEP, TIER_COUNT }; // 不用 NEAR/FAR: 与 Windows 头文件中的宏冲突
+
+    // 一次更新任务: 怪物下标与要补上的时间
+    struct Task {
+        uint32_t monster;
+        float deltaTime;
+        Tier tier;
+    };
+
+    // 每帧的计数
+    struct Stats {
+        size_t inTier[TIER_COUNT] = {}; // 各档的怪物数
+        size_t updated[TIER_COUNT] = {}; // 各档本帧实际更新的怪物数 (TIER_SLEEP 恒为 0)
+        size_t deferred = 0;             // 因超出预算推迟到下一帧的怪物数
+    };
+
+    explicit AiLodScheduler(const AiLodSettings& lodSettings = AiLodSettings()) : settings(lodSettings) {}
+
+    // 换关或怪物列表整体替换后调用，清空累计时间
+    void Reset();
+
+    // 为本帧生成更新任务 (近处在前，之后是预算内的中距离/远处任务)
+    void Schedule(const std::vector<Monster>& monsters, const Player& player, float deltaTime);
+
+    // 报告本帧中距离/远处任务的实测总耗时 (秒)，用于估算下一帧的预算能容纳多少任务
+    void ReportCost(double midSeconds, double farSeconds);
+
+    const std::vector<Task>& Tasks() const { return tasks; }
+    const Stats& LastStats() const { return stats; }
+    const AiLodSettings& Settings() const { return settings; }
+    AiLodSettings& Settings() { return settings; }
+
+private:
+    AiLodSettings settings;
+    uint64_t frame = 0;
+    std::vector<float> pendingTime;  // 每个怪物尚未补上的时间
+    std::vector<uint8_t> deferred;   // 上一帧到期但被预算推迟
+    std::vector<Task> tasks;
+    std::vector<Task> candidates;    // 本帧到期的中距离/远处任务 (推迟过的在前)
+    Stats stats;
+    double averageCost[TIER_COUNT] = { 0.0, 20e-6, 2e-6, 0.0 }; // 单次更新耗时的滑动平均 (秒)
+};
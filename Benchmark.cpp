@@ -0,0 +1,1352 @@
+#include "Benchmark.h"
+#include "MazeGenerator.h"
+#include "EllerGenerator.h"
+#include "ChunkedMaze.h"
+#include "Level.h"
+#include "MazePathfinder.h"
+#include "FlowField.h"
+#include "LineOfSight.h"
+#include "MonsterSwarm.h"
+#include "MonsterUpdater.h"
+#include "AiLodScheduler.h"
+#include "PathService.h"
+#include "PathCache.h"
+#include "MazeMesh.h"
+#include "Player.h"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <memory>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+
+// 计时辅助: 返回函数执行耗时 (秒)
+template <typename Func>
+static double MeasureSeconds(Func&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// 迷宫生成速度: 不同尺寸下每秒生成的单元格数
+static void RunMazeGenerationBenchmark() {
+    std::cout << "--- Maze generation (iterative backtracker) ---\n";
+    const int sizes[] = { 64, 256, 1024, 2048, 4096 };
+    for (int size : sizes) {
+        MazeGenerator mazeGen(size, size, 12345u);
+        double seconds = MeasureSeconds([&]() { mazeGen.Generate(GenerationMode::Iterative); });
+        double cells = static_cast<double>(size) * size;
+        std::cout << std::setw(5) << size << " x " << std::setw(5) << size
+                  << "  " << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms"
+                  << "  " << std::setprecision(2) << cells / seconds / 1e6 << " Mcells/s"
+                  << "  " << mazeGen.maze.MemoryBytes() / 1024 << " KB\n";
+    }
+}
+
+// 分块并行生成的扩展性: 同一尺寸下 1~16 个线程
+static void RunParallelGenerationBenchmark() {
+    const int size = 4096;
+    std::cout << "--- Parallel tiled generation " << size << " x " << size
+              << " (" << std::thread::hardware_concurrency() << " hardware threads) ---\n";
+    const int threadCounts[] = { 1, 2, 4, 8, 16 };
+    double baseline = 0.0;
+    for (int threads : threadCounts) {
+        MazeGenerator mazeGen(size, size, 12345u);
+        double seconds = MeasureSeconds([&]() { mazeGen.GenerateParallel(threads); });
+        if (threads == 1) baseline = seconds;
+        std::cout << std::setw(2) << threads << " threads"
+                  << "  " << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms"
+                  << "  " << std::setprecision(2) << static_cast<double>(size) * size / seconds / 1e6 << " Mcells/s"
+                  << "  speedup " << baseline / seconds << "x\n";
+    }
+}
+
+// 迷宫统计: 死胡同数量与最长路径 (生成树的直径)
+struct MazeStats {
+    size_t deadEnds = 0;
+    int longestPath = 0;
+};
+
+// 从 start 出发做 BFS，返回最远的格子并把距离写入 farthestDistance
+static size_t FarthestCell(const MazeGrid& grid, size_t start, std::vector<int>& distance, int& farthestDistance) {
+    static const int DX[4] = { 0, 1, 0, -1 };
+    static const int DY[4] = { -1, 0, 1, 0 };
+    std::fill(distance.begin(), distance.end(), -1);
+    std::vector<size_t> queue;
+    queue.reserve(distance.size());
+    queue.push_back(start);
+    distance[start] = 0;
+    size_t farthest = start;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        size_t cell = queue[head];
+        int x = static_cast<int>(cell % grid.width), y = static_cast<int>(cell / grid.width);
+        if (distance[cell] > distance[farthest]) farthest = cell;
+        for (int dir = 0; dir < 4; ++dir) {
+            if (grid.HasWall(x, y, dir)) continue;
+            size_t next = static_cast<size_t>(y + DY[dir]) * grid.width + (x + DX[dir]);
+            if (distance[next] < 0) {
+                distance[next] = distance[cell] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+    farthestDistance = distance[farthest];
+    return farthest;
+}
+
+static MazeStats ComputeMazeStats(const MazeGrid& grid) {
+    MazeStats stats;
+    for (int y = 0; y < grid.height; ++y) {
+        for (int x = 0; x < grid.width; ++x) {
+            int walls = 0;
+            for (int dir = 0; dir < 4; ++dir) walls += grid.HasWall(x, y, dir);
+            if (walls == 3) ++stats.deadEnds;
+        }
+    }
+    std::vector<int> distance(static_cast<size_t>(grid.width) * grid.height);
+    int ignored = 0;
+    size_t end = FarthestCell(grid, 0, distance, ignored);
+    FarthestCell(grid, end, distance, stats.longestPath);
+    return stats;
+}
+
+// 各生成算法对比: 耗时、峰值工作内存、死胡同比例、最长路径
+static void RunAlgorithmComparisonBenchmark() {
+    std::cout << "--- Algorithm comparison ---\n";
+    const GenerationMode modes[] = { GenerationMode::Iterative, GenerationMode::Kruskal, GenerationMode::Prim,
+                                     GenerationMode::Wilson, GenerationMode::Eller };
+    const int sizes[] = { 256, 1024, 2048 };
+    for (int size : sizes) {
+        for (GenerationMode mode : modes) {
+            std::unique_ptr<MazeAlgorithm> algorithm = CreateMazeAlgorithm(mode);
+            MazeGenerator mazeGen(size, size, 12345u);
+            double seconds = MeasureSeconds([&]() { mazeGen.Generate(*algorithm); });
+            MazeStats stats = ComputeMazeStats(mazeGen.maze);
+            double cells = static_cast<double>(size) * size;
+            std::cout << std::setw(5) << size << "  " << std::left << std::setw(12) << algorithm->Name() << std::right
+                      << std::fixed << std::setprecision(3) << std::setw(10) << seconds * 1000.0 << " ms"
+                      << std::setw(9) << (algorithm->PeakWorkingBytes() + mazeGen.maze.MemoryBytes()) / 1024 << " KB peak"
+                      << "  dead ends " << std::setprecision(1) << std::setw(5) << stats.deadEnds * 100.0 / cells << "%"
+                      << "  longest path " << stats.longestPath << "\n";
+        }
+    }
+}
+
+// 流式生成速度: 固定宽度下逐行生成，工作内存只与宽度有关
+static void RunEllerStreamingBenchmark() {
+    std::cout << "--- Streaming rows (Eller) ---\n";
+    const int widths[] = { 64, 1024, 4096 };
+    const int rows = 10000;
+    for (int width : widths) {
+        EllerGenerator eller(width, 12345u);
+        size_t openings = 0;
+        double seconds = MeasureSeconds([&]() {
+            eller.Run(rows, [&](const MazeRow& row) {
+                openings += (row.walls[0] & 2u) ? 0 : 1;
+                return true;
+            });
+        });
+        double cells = static_cast<double>(width) * rows;
+        std::cout << std::setw(5) << width << " x " << rows << " rows"
+                  << "  " << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms"
+                  << "  " << std::setprecision(2) << cells / seconds / 1e6 << " Mcells/s"
+                  << "  " << openings << " openings in column 0\n";
+    }
+}
+
+// 生成树索引: 建立耗时、内存、距离/下一步查询速度，并与 BFS 的结果逐格对比 (返回是否一致)
+static bool RunMazeTreeBenchmark() {
+    std::cout << "--- Spanning-tree distance index ---\n";
+    const int sizes[] = { 20, 256, 1024, 2048 };
+    const int queries = 1000000;
+    bool allOk = true;
+    for (int size : sizes) {
+        MazeGenerator mazeGen(size, size, 12345u);
+        mazeGen.Generate();
+        double buildSeconds = MeasureSeconds([&]() { mazeGen.BuildTree(); });
+        const MazeTree& tree = mazeGen.tree;
+        const int cellCount = size * size;
+
+        std::mt19937 rng(7u);
+        std::vector<int> pairs(queries * 2);
+        for (int& cell : pairs) cell = static_cast<int>(rng() % cellCount);
+        long long checksum = 0;
+        double distanceSeconds = MeasureSeconds([&]() {
+            for (int i = 0; i < queries; ++i) checksum += tree.Distance(pairs[i * 2], pairs[i * 2 + 1]);
+        });
+        double nextSeconds = MeasureSeconds([&]() {
+            for (int i = 0; i < queries; ++i) checksum += tree.NextStep(pairs[i * 2], pairs[i * 2 + 1]);
+        });
+
+        // 与 BFS 对比: 若干个起点到所有格子的距离，以及下一步确实是相邻的通路且离目标近一步
+        bool ok = true;
+        std::vector<int> distance(cellCount);
+        int ignored = 0;
+        for (int source = 0; source < 8 && ok; ++source) {
+            int start = static_cast<int>(rng() % cellCount);
+            FarthestCell(mazeGen.maze, start, distance, ignored);
+            for (int cell = 0; cell < cellCount && ok; ++cell) {
+                ok = tree.Distance(start, cell) == distance[cell];
+                if (!ok || cell == start) continue;
+                int next = tree.NextStep(cell, start);
+                int dx = next % size - cell % size, dy = next / size - cell / size;
+                int dir = dx == 1 ? WALL_RIGHT : dx == -1 ? WALL_LEFT : dy == 1 ? WALL_BOTTOM : WALL_TOP;
+                ok = std::abs(dx) + std::abs(dy) == 1 && !mazeGen.maze.HasWall(cell % size, cell / size, dir)
+                    && distance[next] == distance[cell] - 1;
+            }
+        }
+        allOk = allOk && ok;
+
+        std::cout << std::setw(5) << size << " x " << std::setw(5) << size
+                  << "  build " << std::fixed << std::setprecision(3) << buildSeconds * 1000.0 << " ms"
+                  << "  " << tree.MemoryBytes() / 1024 << " KB"
+                  << "  distance " << std::setprecision(2) << queries / distanceSeconds / 1e6 << " Mq/s"
+                  << "  next step " << queries / nextSeconds / 1e6 << " Mq/s"
+                  << "  BFS check " << (ok ? "OK" : "FAILED")
+                  << "  (checksum " << checksum << ")\n";
+    }
+    return allOk;
+}
+
+// A* 寻路: 随机起终点的每秒搜索次数；路径长度与生成树距离对比，内存在预热后不应再增长 (返回是否正确)
+static bool RunPathfindingBenchmark() {
+    std::cout << "--- A* pathfinding (pooled nodes, indexed heap) ---\n";
+    const int sizes[] = { 20, 256, 2048 };
+    const int searchCounts[] = { 100000, 1000, 20 };
+    bool allOk = true;
+    for (int i = 0; i < 3; ++i) {
+        const int size = sizes[i], searches = searchCounts[i];
+        MazeGenerator mazeGen(size, size, 12345u);
+        mazeGen.Generate();
+        mazeGen.BuildTree();
+
+        std::mt19937 rng(11u);
+        std::vector<int> pairs(searches * 2);
+        for (int& cell : pairs) cell = static_cast<int>(rng() % (size * size));
+
+        MazePathfinder pathfinder;
+        std::vector<int> path;
+        // 预热: 第一次搜索分配节点数组与堆
+        pathfinder.FindPath(mazeGen.maze, 0, 0, size - 1, size - 1, path);
+        size_t warmBytes = pathfinder.MemoryBytes();
+
+        bool ok = true;
+        size_t expanded = 0;
+        double seconds = MeasureSeconds([&]() {
+            for (int s = 0; s < searches; ++s) {
+                int a = pairs[s * 2], b = pairs[s * 2 + 1];
+                ok = pathfinder.FindPath(mazeGen.maze, a % size, a / size, b % size, b / size, path) && ok;
+                ok = ok && static_cast<int>(path.size()) == mazeGen.tree.Distance(a, b) + 1;
+                expanded += pathfinder.LastExpanded();
+            }
+        });
+        ok = ok && pathfinder.MemoryBytes() == warmBytes;
+        allOk = allOk && ok;
+
+        std::cout << std::setw(5) << size << " x " << std::setw(5) << size
+                  << "  " << std::fixed << std::setprecision(1) << std::setw(10) << searches / seconds << " searches/s"
+                  << "  " << std::setprecision(0) << static_cast<double>(expanded) / searches << " nodes/search"
+                  << "  " << pathfinder.MemoryBytes() / 1024 << " KB"
+                  << "  check " << (ok ? "OK" : "FAILED") << "\n";
+    }
+    return allOk;
+}
+
+// 分层寻路 (HPA*) 与平面 A* 对比 (1024 x 1024): 展开的节点数、首段可走的延迟与完整展开的耗时；
+// 完美迷宫中两格之间的路径唯一，完整展开的格子序列必须与平面 A* 的结果逐格相同 (返回是否正确)
+static bool RunHierarchicalPathfindingBenchmark() {
+    const int size = 1024, searches = 40;
+    std::cout << "--- Hierarchical pathfinding (HPA*) vs flat A* " << size << " x " << size << " ---\n";
+    MazeGenerator mazeGen(size, size, 12345u);
+    mazeGen.Generate();
+
+    std::mt19937 rng(13u);
+    std::vector<int> pairs(searches * 2);
+    for (int& cell : pairs) cell = static_cast<int>(rng() % (size * size));
+
+    // 平面 A* 的结果作为参照
+    MazePathfinder flat;
+    std::vector<std::vector<int>> flatPaths(searches);
+    size_t flatExpanded = 0;
+    double flatSeconds = MeasureSeconds([&]() {
+        for (int s = 0; s < searches; ++s) {
+            int a = pairs[s * 2], b = pairs[s * 2 + 1];
+            flat.FindPath(mazeGen.maze, a % size, a / size, b % size, b / size, flatPaths[s]);
+            flatExpanded += flat.LastExpanded();
+        }
+    });
+    std::cout << "flat A*            " << std::fixed << std::setprecision(3) << std::setw(8) << flatSeconds / searches * 1000.0
+              << " ms/search  " << std::setprecision(0) << static_cast<double>(flatExpanded) / searches << " nodes/search\n";
+
+    bool ok = true;
+    const int clusterSizes[] = { 8, 16, 32 };
+    for (int clusterSize : clusterSizes) {
+        double buildSeconds = MeasureSeconds([&]() { mazeGen.BuildHierarchy(clusterSize); });
+        const MazeHierarchy& hierarchy = mazeGen.hierarchy;
+        HierarchicalPathfinder hpa;
+        std::vector<int> waypoints, cells;
+        size_t abstractExpanded = 0, firstLocal = 0, fullLocal = 0;
+        double searchSeconds = 0.0, firstSeconds = 0.0, fullSeconds = 0.0;
+        bool same = true;
+        for (int s = 0; s < searches; ++s) {
+            int a = pairs[s * 2], b = pairs[s * 2 + 1];
+            // 抽象搜索 + 展开到第一个簇边界: 怪物此时就可以开始走
+            bool found = false;
+            searchSeconds += MeasureSeconds([&]() {
+                found = hpa.FindPath(hierarchy, mazeGen.maze, a % size, a / size, b % size, b / size, waypoints);
+            });
+            abstractExpanded += hpa.LastExpanded();
+            cells.assign(1, a);
+            size_t next = 1;
+            firstSeconds += MeasureSeconds([&]() {
+                while (next < waypoints.size()) {
+                    bool crossing = hierarchy.ClusterOf(waypoints[next - 1]) != hierarchy.ClusterOf(waypoints[next]);
+                    hpa.RefineSegment(hierarchy, mazeGen.maze, waypoints[next - 1], waypoints[next], cells);
+                    ++next;
+                    if (!crossing) break;
+                }
+            });
+            firstLocal += hpa.LocalVisited();
+            // 其余各段全部展开 (用于校验)
+            fullSeconds += MeasureSeconds([&]() {
+                for (; next < waypoints.size(); ++next) {
+                    hpa.RefineSegment(hierarchy, mazeGen.maze, waypoints[next - 1], waypoints[next], cells);
+                }
+            });
+            fullLocal += hpa.LocalVisited();
+            same = same && found && cells == flatPaths[s];
+        }
+        ok = ok && same;
+        double firstMs = (searchSeconds + firstSeconds) / searches * 1000.0;
+        std::cout << "HPA* cluster " << std::setw(2) << clusterSize << "    " << std::setprecision(3) << std::setw(8) << firstMs
+                  << " ms to first move  " << std::setw(8) << (searchSeconds + firstSeconds + fullSeconds) / searches * 1000.0
+                  << " ms fully refined  speedup " << std::setprecision(1) << flatSeconds / searches * 1000.0 / firstMs << "x\n"
+                  << "    abstract " << hierarchy.NodeCount() << " nodes, " << hierarchy.EdgeCount() << " edges, "
+                  << hierarchy.MemoryBytes() / 1024 << " KB, built in " << std::setprecision(1) << buildSeconds * 1000.0 << " ms\n"
+                  << "    nodes/search: abstract " << std::setprecision(0) << static_cast<double>(abstractExpanded) / searches
+                  << " + cells " << static_cast<double>(firstLocal) / searches << " to first move, "
+                  << static_cast<double>(fullLocal) / searches << " fully refined  path " << (same ? "OK" : "FAILED") << "\n";
+    }
+    return ok;
+}
+
+// 走廊图: 各尺寸下的压缩比与建图耗时；走廊图上的 A* 与平面 A* 对比 (路径必须逐格相同)，
+// 走廊图上的距离场与 FlowField 的重建耗时对比 (每格的下一步必须相同) (返回是否正确)
+static bool RunCorridorGraphBenchmark() {
+    std::cout << "--- Corridor graph (junctions and dead ends only) ---\n";
+    bool ok = true;
+    const int sizes[] = { 256, 1024 };
+    const int searchCounts[] = { 2000, 40 };
+    for (int i = 0; i < 2; ++i) {
+        const int size = sizes[i], searches = searchCounts[i];
+        MazeGenerator mazeGen(size, size, 12345u);
+        mazeGen.Generate();
+        double buildSeconds = MeasureSeconds([&]() { mazeGen.BuildCorridors(); });
+        const CorridorGraph& graph = mazeGen.corridors;
+        const double cells = static_cast<double>(size) * size;
+        std::cout << std::setw(5) << size << " x " << std::setw(5) << size << "  " << graph.NodeCount() << " nodes, "
+                  << graph.EdgeCount() << " edges (" << std::fixed << std::setprecision(1) << cells / graph.NodeCount()
+                  << "x fewer nodes than cells)  built in " << std::setprecision(1) << buildSeconds * 1000.0 << " ms  graph "
+                  << graph.GraphBytes() / 1024 << " KB + cell index " << (graph.MemoryBytes() - graph.GraphBytes()) / 1024 << " KB\n";
+
+        std::mt19937 rng(17u);
+        std::vector<int> pairs(searches * 2);
+        for (int& cell : pairs) cell = static_cast<int>(rng() % (size * size));
+        MazePathfinder flat;
+        CorridorPathfinder corridor;
+        std::vector<int> flatPath, corridorPath;
+        size_t flatExpanded = 0, corridorExpanded = 0;
+        double flatSeconds = 0.0, corridorSeconds = 0.0;
+        bool same = true;
+        for (int s = 0; s < searches; ++s) {
+            int a = pairs[s * 2], b = pairs[s * 2 + 1];
+            flatSeconds += MeasureSeconds([&]() { flat.FindPath(mazeGen.maze, a % size, a / size, b % size, b / size, flatPath); });
+            corridorSeconds += MeasureSeconds([&]() { corridor.FindPath(graph, size, a % size, a / size, b % size, b / size, corridorPath); });
+            flatExpanded += flat.LastExpanded();
+            corridorExpanded += corridor.LastExpanded();
+            same = same && corridorPath == flatPath;
+        }
+        ok = ok && same;
+        std::cout << "    A*  grid " << std::setprecision(3) << flatSeconds / searches * 1000.0 << " ms, "
+                  << std::setprecision(0) << static_cast<double>(flatExpanded) / searches << " nodes  corridor "
+                  << std::setprecision(3) << corridorSeconds / searches * 1000.0 << " ms, "
+                  << std::setprecision(0) << static_cast<double>(corridorExpanded) / searches << " nodes  speedup "
+                  << std::setprecision(1) << flatSeconds / corridorSeconds << "x  path " << (same ? "OK" : "FAILED") << "\n";
+
+        // 距离场: 目标换 20 次，各重建一次
+        const int rebuilds = 20;
+        FlowField field;
+        CorridorFlowField corridorField;
+        double fieldSeconds = 0.0, corridorFieldSeconds = 0.0;
+        bool nextSame = true;
+        for (int r = 0; r < rebuilds; ++r) {
+            int target = static_cast<int>(rng() % (size * size));
+            fieldSeconds += MeasureSeconds([&]() { field.Update(mazeGen.maze, target % size, target / size); });
+            corridorFieldSeconds += MeasureSeconds([&]() { corridorField.Update(graph, target); });
+            // 抽查 1000 格的下一步
+            for (int k = 0; k < 1000; ++k) {
+                int cell = static_cast<int>(rng() % (size * size));
+                nextSame = nextSame && field.NextCell(cell % size, cell / size) == corridorField.NextCell(graph, cell);
+            }
+        }
+        ok = ok && nextSame;
+        std::cout << "    flow field rebuild  grid " << std::setprecision(3) << fieldSeconds / rebuilds * 1000.0 << " ms  corridor "
+                  << corridorFieldSeconds / rebuilds * 1000.0 << " ms  speedup " << std::setprecision(1)
+                  << fieldSeconds / corridorFieldSeconds << "x  next step " << (nextSame ? "OK" : "FAILED") << "\n";
+    }
+
+    // 迷宫重新生成、目标格不变: 距离场必须按新的走廊图重建
+    MazeGenerator before(64, 64, 1u), after(64, 64, 2u);
+    before.Generate();
+    after.Generate();
+    CorridorGraph graph;
+    graph.Build(before.maze);
+    CorridorFlowField corridorField;
+    corridorField.Update(graph, 0);
+    graph.Build(after.maze);
+    FlowField field;
+    field.Update(after.maze, 0, 0);
+    bool rebuilt = corridorField.Update(graph, 0);
+    for (int cell = 0; cell < 64 * 64; ++cell) rebuilt = rebuilt && field.NextCell(cell % 64, cell / 64) == corridorField.NextCell(graph, cell);
+    ok = ok && rebuilt;
+    std::cout << "    new maze, same target: flow field rebuilt " << (rebuilt ? "OK" : "FAILED") << "\n";
+    return ok;
+}
+
+// 逐格路径是否从 start 到 goal、每步穿过相通的相邻格，且长度等于生成树距离 (需要 mazeGen.tree)
+static bool IsShortestPath(const MazeGenerator& mazeGen, int start, int goal, const std::vector<int>& cells) {
+    const int width = mazeGen.width;
+    if (static_cast<int>(cells.size()) != mazeGen.tree.Distance(start, goal) + 1 || cells.front() != start || cells.back() != goal) return false;
+    for (size_t k = 1; k < cells.size(); ++k) {
+        int from = cells[k - 1], to = cells[k];
+        int dx = to % width - from % width, dy = to / width - from / width;
+        int dir = dx == 1 ? WALL_RIGHT : dx == -1 ? WALL_LEFT : dy == 1 ? WALL_BOTTOM : WALL_TOP;
+        if (std::abs(dx) + std::abs(dy) != 1 || mazeGen.maze.HasWall(from % width, from / width, dir)) return false;
+    }
+    return true;
+}
+
+// 寻路服务: 2000 个怪物在同一帧对 4 个终点发出请求，与同一帧内逐个同步 A* 对比；
+// 服务按 1 ms 时间片分帧完成，检查路径长度、连通性以及 Reset 会取消进行中的请求 (返回是否正确)
+static bool RunPathServiceBenchmark() {
+    std::cout << "--- Path service (coalesced requests, 1 ms per-frame budget) ---\n";
+    const int size = 256, requests = 2000, goalCount = 4;
+    MazeGenerator mazeGen(size, size, 12345u);
+    mazeGen.Generate();
+    mazeGen.BuildTree();
+
+    std::mt19937 rng(23u);
+    std::vector<int> starts(requests), goals(goalCount);
+    for (int& cell : starts) cell = static_cast<int>(rng() % (size * size));
+    for (int& cell : goals) cell = static_cast<int>(rng() % (size * size));
+
+    MazePathfinder pathfinder;
+    std::vector<int> path;
+    double syncSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < requests; ++i) {
+            int a = starts[i], b = goals[i % goalCount];
+            pathfinder.FindPath(mazeGen.maze, a % size, a / size, b % size, b / size, path);
+        }
+    });
+
+    PathService service;
+    for (int i = 0; i < requests; ++i) service.Submit(static_cast<uint32_t>(i), starts[i], goals[i % goalCount]);
+    for (int i = 0; i < requests; i += 10) service.Submit(static_cast<uint32_t>(i), starts[i], goals[i % goalCount]); // 重复提交
+    bool ok = true;
+    int frames = 0;
+    size_t delivered = 0;
+    double totalSeconds = 0.0;
+    const double budget = 0.001;
+    std::vector<double> slices;
+    while (service.PendingCount() > 0 && frames < 10000) {
+        double slice = MeasureSeconds([&]() { service.Service(mazeGen, budget); });
+        slices.push_back(slice);
+        totalSeconds += slice;
+        ++frames;
+        for (const PathResult& result : service.Results()) {
+            ok = ok && !result.waypoints && IsShortestPath(mazeGen, starts[result.requester], goals[result.requester % goalCount], result.cells);
+            ++delivered;
+        }
+    }
+    ok = ok && delivered == static_cast<size_t>(requests);
+    // 时间片的 99 百分位与最大值 (最大值会受线程被系统抢占的影响)
+    auto sliceSummary = [&](std::vector<double>& times) {
+        std::sort(times.begin(), times.end());
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(3) << "p99 " << times[std::min(times.size() - 1, times.size() * 99 / 100)] * 1000.0
+             << " ms, worst " << times.back() * 1000.0 << " ms (budget " << budget * 1000.0 << " ms)";
+        return text.str();
+    };
+    const PathService::Stats& stats = service.GetStats();
+    std::cout << std::setw(5) << size << " x " << std::setw(5) << size << "  " << requests << " requests to " << goalCount << " goals\n"
+              << "    synchronous A*  " << std::fixed << std::setprecision(2) << syncSeconds * 1000.0 << " ms in one frame\n"
+              << "    service  " << frames << " frames, slice " << sliceSummary(slices) << ", total "
+              << std::setprecision(2) << totalSeconds * 1000.0 << " ms  " << stats.searches << " searches, "
+              << stats.coalesced << " coalesced, " << stats.duplicates << " duplicates  paths " << (ok ? "OK" : "FAILED") << "\n";
+
+    // 每组只有一个请求 (终点各不相同) 时走分层 / 走廊搜索，它们不可分帧，靠展开上限约束单帧耗时
+    auto singleSlices = [&]() {
+        PathService singles;
+        for (int i = 0; i < 200; ++i) singles.Submit(static_cast<uint32_t>(i), starts[i], starts[requests - 1 - i]);
+        std::vector<double> times;
+        for (int f = 0; f < 10000 && singles.PendingCount() > 0; ++f) {
+            times.push_back(MeasureSeconds([&]() { singles.Service(mazeGen, budget); }));
+        }
+        return sliceSummary(times);
+    };
+    mazeGen.BuildCorridors();
+    std::string corridorSlices = singleSlices();
+    mazeGen.BuildHierarchy();
+    std::string hierarchySlices = singleSlices();
+    std::cout << "    200 single requests  corridor slice " << corridorSlices << "\n"
+              << "                         hierarchical slice " << hierarchySlices << "\n";
+
+    // 只有一个请求且建立了分层寻路图时交付路点 (选一对展开节点数不超过上限的起终点)
+    HierarchicalPathfinder probe;
+    int waypointStart = starts[0];
+    for (int i = 0; i < requests; ++i) {
+        const int a = starts[i], b = goals[0];
+        if (probe.FindPath(mazeGen.hierarchy, mazeGen.maze, a % size, a / size, b % size, b / size, path)
+            && probe.LastExpanded() <= PathService::SINGLE_SEARCH_MAX_EXPANDED) {
+            waypointStart = a;
+            break;
+        }
+    }
+    PathService single;
+    single.Submit(0, waypointStart, goals[0]);
+    single.Service(mazeGen, 0.0);
+    bool waypointsOk = single.Results().size() == 1 && single.Results()[0].waypoints
+        && single.Results()[0].cells.front() == waypointStart && single.Results()[0].cells.back() == goals[0];
+
+    // Reset 取消进行中的请求: 之后不再交付任何结果
+    PathService cancelled;
+    for (int i = 0; i < requests; ++i) cancelled.Submit(static_cast<uint32_t>(i), starts[i], goals[i % goalCount]);
+    cancelled.Service(mazeGen, 1e-5);
+    cancelled.Reset();
+    bool resetOk = cancelled.PendingCount() == 0;
+    cancelled.Service(mazeGen, 0.0);
+    resetOk = resetOk && cancelled.Results().empty() && cancelled.GetStats().cancelled > 0;
+    std::cout << "    single request waypoints " << (waypointsOk ? "OK" : "FAILED") << "  reset cancels "
+              << cancelled.GetStats().cancelled << " pending " << (resetOk ? "OK" : "FAILED") << "\n";
+    return ok && waypointsOk && resetOk;
+}
+
+// 路径缓存: 300 个怪物追逐玩家 (玩家先后停在 6 个格子)，每个怪物沿路径走 8 格后重新请求；
+// 与每次都做 A* 对比不同容量下的命中率、淘汰数和耗时，并检查迷宫重新生成后缓存失效 (返回是否正确)
+static bool RunPathCacheBenchmark() {
+    std::cout << "--- Path cache (LRU, suffix reuse, maze epoch) ---\n";
+    const int size = 128, monsterCount = 300, goalCount = 6, rounds = 3, stepsPerRound = 8;
+    MazeGenerator mazeGen(size, size, 12345u);
+    mazeGen.Generate();
+    mazeGen.BuildTree();
+
+    std::mt19937 rng(29u);
+    std::vector<int> initial(monsterCount), goals(goalCount);
+    for (int& cell : initial) cell = static_cast<int>(rng() % (size * size));
+    // 玩家每次只走出一小段，相邻两个目标格相距不远
+    goals[0] = static_cast<int>(rng() % (size * size));
+    for (int g = 1; g < goalCount; ++g) {
+        int cell = goals[g - 1];
+        for (int step = 0; step < 12; ++step) {
+            int candidates[4], count = 0;
+            for (int dir = 0; dir < 4; ++dir) {
+                if (mazeGen.maze.HasWall(cell % size, cell / size, dir)) continue;
+                candidates[count++] = dir == WALL_TOP ? cell - size : dir == WALL_RIGHT ? cell + 1 : dir == WALL_BOTTOM ? cell + size : cell - 1;
+            }
+            cell = candidates[rng() % count];
+        }
+        goals[g] = cell;
+    }
+
+    MazePathfinder pathfinder;
+    auto simulate = [&](PathCache* cache, bool& ok) {
+        std::vector<int> positions = initial, path;
+        for (int g = 0; g < goalCount; ++g) {
+            for (int round = 0; round < rounds; ++round) {
+                for (int m = 0; m < monsterCount; ++m) {
+                    int start = positions[m], goal = goals[g];
+                    if (!cache || !cache->Lookup(mazeGen.epoch, start, goal, path)) {
+                        pathfinder.FindPath(mazeGen.maze, start % size, start / size, goal % size, goal / size, path);
+                        if (cache) cache->Insert(mazeGen.epoch, path);
+                    }
+                    ok = ok && IsShortestPath(mazeGen, start, goal, path);
+                    positions[m] = path[std::min<size_t>(stepsPerRound, path.size() - 1)];
+                }
+            }
+        }
+    };
+    bool ok = true;
+    double uncachedSeconds = MeasureSeconds([&]() { simulate(nullptr, ok); });
+    const int requests = goalCount * rounds * monsterCount;
+    std::cout << std::setw(5) << size << " x " << std::setw(5) << size << "  " << requests << " requests  A* every time "
+              << std::fixed << std::setprecision(1) << uncachedSeconds * 1000.0 << " ms\n";
+
+    const size_t entryLimits[] = { 64, 512, 4096 };
+    const size_t cellLimits[] = { 1u << 12, 1u << 15, 1u << 18 };
+    for (int c = 0; c < 3; ++c) {
+        PathCache cache(entryLimits[c], cellLimits[c]);
+        bool cachedOk = true;
+        double seconds = MeasureSeconds([&]() { simulate(&cache, cachedOk); });
+        ok = ok && cachedOk;
+        const PathCache::Stats& stats = cache.GetStats();
+        std::cout << "    cache " << std::setw(4) << entryLimits[c] << " paths / " << std::setw(7) << cellLimits[c] << " cells  "
+                  << std::setprecision(1) << seconds * 1000.0 << " ms (" << uncachedSeconds / seconds << "x)  hits "
+                  << stats.hits << "  suffix hits " << stats.suffixHits << "  misses " << stats.misses
+                  << "  evictions " << stats.evictions << "  paths " << (cachedOk ? "OK" : "FAILED") << "\n";
+    }
+
+    // 重新生成迷宫后，同样的查询不能命中旧路径
+    PathCache cache;
+    std::vector<int> path;
+    pathfinder.FindPath(mazeGen.maze, 0, 0, size - 1, size - 1, path);
+    cache.Insert(mazeGen.epoch, path);
+    bool epochOk = cache.Lookup(mazeGen.epoch, 0, size * size - 1, path);
+    mazeGen.Generate();
+    epochOk = epochOk && !cache.Lookup(mazeGen.epoch, 0, size * size - 1, path)
+        && cache.GetStats().invalidations == 1 && cache.EntryCount() == 0;
+    std::cout << "    invalidated on Generate " << (epochOk ? "OK" : "FAILED") << "\n";
+    return ok && epochOk;
+}
+
+// 共享流场: 每帧为 N 个追逐的怪物求下一步 (流场重建一次 + N 次查表)，与逐个 A* / 生成树查询对比；
+// 并检查沿流场走到目标的步数等于迷宫距离 (返回是否正确)
+static bool RunFlowFieldBenchmark() {
+    const int size = 256;
+    std::cout << "--- Shared flow field vs per-monster search (" << size << " x " << size << ", player moves every frame) ---\n";
+    MazeGenerator mazeGen(size, size, 12345u);
+    mazeGen.Generate();
+    mazeGen.BuildTree();
+    const int cellCount = size * size;
+    std::mt19937 rng(5u);
+
+    FlowField field;
+    MazePathfinder pathfinder;
+    std::vector<int> path;
+    const int monsterCounts[] = { 100, 1000, 10000 };
+    const int frames = 20;
+    for (int count : monsterCounts) {
+        std::vector<int> monsters(count);
+        for (int& cell : monsters) cell = static_cast<int>(rng() % cellCount);
+        std::vector<int> playerCells(frames);
+        for (int& cell : playerCells) cell = static_cast<int>(rng() % cellCount);
+
+        long long checksum = 0;
+        double fieldSeconds = MeasureSeconds([&]() {
+            for (int f = 0; f < frames; ++f) {
+                field.Update(mazeGen.maze, playerCells[f] % size, playerCells[f] / size);
+                for (int cell : monsters) checksum += field.NextCell(cell % size, cell / size);
+            }
+        });
+        double treeSeconds = MeasureSeconds([&]() {
+            for (int f = 0; f < frames; ++f) {
+                for (int cell : monsters) checksum += mazeGen.tree.NextStep(cell, playerCells[f]);
+            }
+        });
+        // 逐个 A* 太慢，只搜前 100 个怪物再按数量折算
+        int searched = std::min(count, 100);
+        double searchSeconds = MeasureSeconds([&]() {
+            for (int i = 0; i < searched; ++i) {
+                int goal = playerCells[0];
+                pathfinder.FindPath(mazeGen.maze, monsters[i] % size, monsters[i] / size, goal % size, goal / size, path);
+                checksum += static_cast<long long>(path.size());
+            }
+        }) * count / searched;
+        std::cout << std::setw(6) << count << " monsters"
+                  << "  flow field " << std::fixed << std::setprecision(3) << fieldSeconds / frames * 1000.0 << " ms/frame"
+                  << "  tree " << treeSeconds / frames * 1000.0 << " ms/frame"
+                  << "  A* each " << searchSeconds * 1000.0 << " ms/frame"
+                  << "  (checksum " << checksum << ")\n";
+    }
+
+    // 沿流场从随机格子走到目标，步数应等于生成树给出的距离
+    bool ok = true;
+    for (int trial = 0; trial < 200 && ok; ++trial) {
+        int goal = static_cast<int>(rng() % cellCount), start = static_cast<int>(rng() % cellCount);
+        field.Update(mazeGen.maze, goal % size, goal / size);
+        int steps = 0;
+        for (int cell = start; cell != goal && steps <= cellCount; ++steps) cell = field.NextCell(cell % size, cell / size);
+        ok = steps == mazeGen.tree.Distance(start, goal);
+    }
+    std::cout << "flow field " << field.MemoryBytes() / 1024 << " KB, " << field.RebuildCount()
+              << " rebuilds, path check " << (ok ? "OK" : "FAILED") << "\n";
+    return ok;
+}
+
+// 线段 p-q 与线段 a-b 是否相交 (闭线段，含端点接触与共线重叠)
+static bool SegmentsTouch(double px, double py, double qx, double qy, double ax, double ay, double bx, double by) {
+    auto cross = [](double ox, double oy, double ux, double uy, double vx, double vy) {
+        return (ux - ox) * (vy - oy) - (uy - oy) * (vx - ox);
+    };
+    auto onSegment = [](double ox, double oy, double ux, double uy, double vx, double vy) {
+        return std::min(ox, ux) <= vx && vx <= std::max(ox, ux) && std::min(oy, uy) <= vy && vy <= std::max(oy, uy);
+    };
+    double d1 = cross(ax, ay, bx, by, px, py), d2 = cross(ax, ay, bx, by, qx, qy);
+    double d3 = cross(px, py, qx, qy, ax, ay), d4 = cross(px, py, qx, qy, bx, by);
+    if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) return true;
+    return (d1 == 0 && onSegment(ax, ay, bx, by, px, py)) || (d2 == 0 && onSegment(ax, ay, bx, by, qx, qy))
+        || (d3 == 0 && onSegment(px, py, qx, qy, ax, ay)) || (d4 == 0 && onSegment(px, py, qx, qy, bx, by));
+}
+
+// 暴力参考: 线段与包围盒内每一堵墙 (含外边界) 逐一求交
+static bool BruteForceLineOfSight(const MazeGrid& grid, float cellSize, float sx, float sy, float ex, float ey) {
+    int x0 = static_cast<int>(std::floor(std::min(sx, ex) / cellSize)), x1 = static_cast<int>(std::floor(std::max(sx, ex) / cellSize));
+    int y0 = static_cast<int>(std::floor(std::min(sy, ey) / cellSize)), y1 = static_cast<int>(std::floor(std::max(sy, ey) / cellSize));
+    if (x0 < 0 || y0 < 0 || x1 >= grid.width || y1 >= grid.height) return false;
+    const double c = cellSize;
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            double left = x * c, right = (x + 1) * c, top = y * c, bottom = (y + 1) * c;
+            if (grid.HasWall(x, y, WALL_RIGHT) && SegmentsTouch(sx, sy, ex, ey, right, top, right, bottom)) return false;
+            if (grid.HasWall(x, y, WALL_BOTTOM) && SegmentsTouch(sx, sy, ex, ey, left, bottom, right, bottom)) return false;
+            if (grid.HasWall(x, y, WALL_LEFT) && SegmentsTouch(sx, sy, ex, ey, left, top, left, bottom)) return false;
+            if (grid.HasWall(x, y, WALL_TOP) && SegmentsTouch(sx, sy, ex, ey, left, top, right, top)) return false;
+        }
+    }
+    return true;
+}
+
+// 视线检测: 与暴力参考对比 (随机线段 + 恰好穿过格角/沿格线的线段)，并测单条与批量检测的速度 (返回是否一致)
+static bool RunLineOfSightBenchmark() {
+    std::cout << "--- Line of sight (grid traversal) ---\n";
+    const float cellSize = 25.0f;
+    bool allOk = true;
+
+    // 1. 正确性: 小迷宫上大量随机线段，以及格子中心之间的线段 (常常恰好穿过格点)
+    {
+        const int size = 12;
+        size_t mismatches = 0, visibleCount = 0, tests = 0, batchMismatches = 0;
+        std::mt19937 rng(3u);
+        std::uniform_real_distribution<float> coord(0.0f, size * cellSize - 0.001f);
+        for (int mazeIndex = 0; mazeIndex < 20; ++mazeIndex) {
+            MazeGenerator mazeGen(size, size, 100u + mazeIndex);
+            mazeGen.Generate(mazeIndex % 2 ? GenerationMode::Kruskal : GenerationMode::Iterative);
+            // 打通一些额外的墙，让视线更长、出现无墙的格点
+            for (int i = 0; i < size * size / 3; ++i) mazeGen.maze.RemoveWall(rng() % size, rng() % size, rng() % 4);
+            auto check = [&](float sx, float sy, float ex, float ey) {
+                bool fast = HasLineOfSight(mazeGen.maze, cellSize, sx, sy, ex, ey);
+                bool reference = BruteForceLineOfSight(mazeGen.maze, cellSize, sx, sy, ex, ey);
+                mismatches += fast != reference;
+                visibleCount += fast;
+                ++tests;
+            };
+            for (int i = 0; i < 20000; ++i) {
+                float sx = coord(rng), sy = coord(rng), ex = coord(rng), ey = coord(rng);
+                check(sx, sy, ex, ey);
+            }
+            for (int i = 0; i < 5000; ++i) {
+                float sx = (rng() % size + 0.5f) * cellSize, sy = (rng() % size + 0.5f) * cellSize;
+                int d = static_cast<int>(rng() % 4) + 1;
+                float ex = sx + (rng() & 1 ? d : -d) * cellSize, ey = sy + (rng() & 1 ? d : -d) * cellSize;
+                if (ex > 0 && ey > 0 && ex < size * cellSize && ey < size * cellSize) check(sx, sy, ex, ey);
+            }
+            // 批量检测 (起点含格子中心，常常恰好穿过格点) 必须与逐条检测一致
+            const int batchRays = 500;
+            std::vector<float> xs(batchRays), ys(batchRays);
+            std::vector<uint8_t> visible(batchRays);
+            float targetX = (rng() % size + 0.5f) * cellSize, targetY = (rng() % size + 0.5f) * cellSize;
+            for (int i = 0; i < batchRays; ++i) {
+                xs[i] = i % 2 ? coord(rng) : (rng() % size + 0.5f) * cellSize;
+                ys[i] = i % 2 ? coord(rng) : (rng() % size + 0.5f) * cellSize;
+            }
+            HasLineOfSightBatch(mazeGen.maze, cellSize, xs.data(), ys.data(), batchRays, targetX, targetY, visible.data());
+            for (int i = 0; i < batchRays; ++i) {
+                bool single = (std::floor(xs[i] / cellSize) == std::floor(targetX / cellSize) && std::floor(ys[i] / cellSize) == std::floor(targetY / cellSize))
+                    || HasLineOfSight(mazeGen.maze, cellSize, xs[i], ys[i], targetX, targetY);
+                batchMismatches += single != (visible[i] != 0);
+            }
+        }
+        allOk = mismatches == 0 && batchMismatches == 0;
+        std::cout << "reference check: " << tests << " segments, " << visibleCount << " visible, "
+                  << mismatches << " mismatches, batch " << batchMismatches << " mismatches  " << (allOk ? "OK" : "FAILED") << "\n";
+    }
+
+    // 2. 速度: 256 x 256 迷宫上长度不超过 8 格的视线 (与怪物的探测范围相当)
+    {
+        const int size = 256, rays = 1000000;
+        MazeGenerator mazeGen(size, size, 12345u);
+        mazeGen.Generate();
+        std::mt19937 rng(9u);
+        std::uniform_real_distribution<float> offset(-8 * cellSize, 8 * cellSize);
+        float targetX = size * cellSize / 2, targetY = size * cellSize / 2;
+        std::vector<float> xs(rays), ys(rays);
+        for (int i = 0; i < rays; ++i) {
+            xs[i] = std::clamp(targetX + offset(rng), 0.0f, size * cellSize - 0.001f);
+            ys[i] = std::clamp(targetY + offset(rng), 0.0f, size * cellSize - 0.001f);
+        }
+        std::vector<uint8_t> singles(rays);
+        double singleSeconds = MeasureSeconds([&]() {
+            for (int i = 0; i < rays; ++i) singles[i] = HasLineOfSight(mazeGen.maze, cellSize, xs[i], ys[i], targetX, targetY);
+        });
+        std::vector<uint8_t> visible(rays);
+        size_t batched = 0;
+        double batchSeconds = MeasureSeconds([&]() {
+            batched = HasLineOfSightBatch(mazeGen.maze, cellSize, xs.data(), ys.data(), rays, targetX, targetY, visible.data());
+        });
+        bool ok = singles == visible;
+        allOk = allOk && ok;
+        std::cout << "256 x 256, " << rays << " rays to one target  single " << std::fixed << std::setprecision(2)
+                  << rays / singleSeconds / 1e6 << " Mrays/s  batch " << rays / batchSeconds / 1e6 << " Mrays/s  "
+                  << batched << " visible  " << (ok ? "OK" : "FAILED") << "\n";
+    }
+    return allOk;
+}
+
+// 潜在可见集: 不同模式/线程数的构建耗时与内存；保守模式必须覆盖所有真实可见的点对 (返回是否满足)
+static bool RunPvsBenchmark() {
+    const int size = 256;
+    const float cellSize = 25.0f;
+    std::cout << "--- Potentially visible set " << size << " x " << size << " (range 8) ---\n";
+    MazeGenerator mazeGen(size, size, 12345u);
+    mazeGen.Generate();
+
+    // 范围内的随机点对及其精确视线结果
+    const int pairs = 200000;
+    std::mt19937 rng(21u);
+    std::uniform_real_distribution<float> inCell(0.001f, 0.999f);
+    std::vector<float> points(pairs * 4);
+    std::vector<uint8_t> exact(pairs);
+    size_t exactVisible = 0;
+    for (int i = 0; i < pairs; ++i) {
+        int ax = rng() % size, ay = rng() % size;
+        int bx = std::clamp(ax + static_cast<int>(rng() % 9) - 4, 0, size - 1);
+        int by = std::clamp(ay + static_cast<int>(rng() % 9) - 4, 0, size - 1);
+        float* p = &points[i * 4];
+        p[0] = (ax + inCell(rng)) * cellSize; p[1] = (ay + inCell(rng)) * cellSize;
+        p[2] = (bx + inCell(rng)) * cellSize; p[3] = (by + inCell(rng)) * cellSize;
+        exact[i] = HasLineOfSight(mazeGen.maze, cellSize, p[0], p[1], p[2], p[3]);
+        exactVisible += exact[i];
+    }
+
+    struct Variant { const char* name; PvsMode mode; int samples; };
+    const Variant variants[] = { { "conservative", PvsMode::Conservative, 0 }, { "sampled 2x2", PvsMode::Sampled, 2 },
+                                 { "sampled 4x4", PvsMode::Sampled, 4 } };
+    const int threadCounts[] = { 1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) };
+    bool ok = true;
+    for (const Variant& variant : variants) {
+        for (int threads : threadCounts) {
+            PvsSettings settings;
+            settings.mode = variant.mode;
+            settings.samplesPerAxis = variant.samples;
+            settings.threadCount = threads;
+            double seconds = MeasureSeconds([&]() { mazeGen.BuildPvs(settings); });
+            std::cout << std::left << std::setw(13) << variant.name << std::right << std::setw(3) << threads << " threads"
+                      << "  build " << std::fixed << std::setprecision(1) << std::setw(8) << seconds * 1000.0 << " ms"
+                      << "  " << mazeGen.pvs.MemoryBytes() / 1024 << " KB"
+                      << "  " << std::setprecision(2) << static_cast<double>(mazeGen.pvs.VisiblePairs()) / (size * size) << " visible cells/cell\n";
+        }
+
+        // 与精确视线对比: 漏判 (真实可见但 PVS 为不可见) 与多判
+        size_t missed = 0, extra = 0;
+        for (int i = 0; i < pairs; ++i) {
+            const float* p = &points[i * 4];
+            bool pvsVisible = mazeGen.pvs.CanSee(static_cast<int>(p[0] / cellSize), static_cast<int>(p[1] / cellSize),
+                                                 static_cast<int>(p[2] / cellSize), static_cast<int>(p[3] / cellSize));
+            missed += exact[i] && !pvsVisible;
+            extra += !exact[i] && pvsVisible;
+        }
+        if (variant.mode == PvsMode::Conservative) ok = ok && missed == 0;
+        std::cout << "    vs exact point LOS (" << exactVisible << " of " << pairs << " visible): missed " << missed
+                  << ", over-reported " << extra
+                  << (variant.mode == PvsMode::Conservative ? (missed == 0 ? "  OK" : "  FAILED") : "") << "\n";
+    }
+
+    // 感知查询: 仅视线 vs 先查 PVS 再做视线
+    mazeGen.BuildPvs();
+    size_t plain = 0, culled = 0;
+    double plainSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < pairs; ++i) {
+            const float* p = &points[i * 4];
+            plain += HasLineOfSight(mazeGen.maze, cellSize, p[0], p[1], p[2], p[3]);
+        }
+    });
+    double culledSeconds = MeasureSeconds([&]() {
+        for (int i = 0; i < pairs; ++i) {
+            const float* p = &points[i * 4];
+            if (!mazeGen.pvs.CanSee(static_cast<int>(p[0] / cellSize), static_cast<int>(p[1] / cellSize),
+                                    static_cast<int>(p[2] / cellSize), static_cast<int>(p[3] / cellSize))) continue;
+            culled += HasLineOfSight(mazeGen.maze, cellSize, p[0], p[1], p[2], p[3]);
+        }
+    });
+    ok = ok && plain == culled;
+    std::cout << "perception queries  LOS only " << std::setprecision(2) << pairs / plainSeconds / 1e6 << " Mq/s"
+              << "  PVS + LOS " << pairs / culledSeconds / 1e6 << " Mq/s  " << (plain == culled ? "OK" : "FAILED") << "\n";
+    return ok;
+}
+
+// SoA 怪物群: 1k / 10k / 100k 个怪物每帧更新耗时 (单线程)，与 std::vector<Monster> 逐个 Update 对比；
+// 并检查所有怪物始终位于相通的两格之间 (返回是否满足)
+static bool RunMonsterSwarmBenchmark() {
+    const int size = 256;
+    const float cellSize = 25.0f;
+    std::cout << "--- Monster update: SoA swarm (SSE) vs std::vector<Monster> (" << size << " x " << size << ") ---\n";
+    MazeGenerator mazeGen(size, size, 12345u);
+    mazeGen.Generate();
+    mazeGen.BuildTree();
+    mazeGen.BuildPvs();
+    FlowField field;
+    const float dt = 1.0f / 60.0f;
+    const int frames = 120;
+    bool ok = true;
+
+    const int counts[] = { 1000, 10000, 100000 };
+    for (int monsterCount : counts) {
+        MonsterSwarm swarm(7u);
+        std::mt19937 rng(3u);
+        for (int i = 0; i < monsterCount; ++i) swarm.Add(rng() % size, rng() % size, cellSize);
+
+        // 玩家沿迷宫中的路径来回走动 (每 10 帧走一格)
+        Player player(size / 2, size / 2, cellSize);
+        size_t scalar = 0;
+        double seconds = 0.0; // 只计怪物更新 (流场重建与怪物数无关，见流场测试)
+        for (int f = 0; f < frames; ++f) {
+            if (f % 10 == 0) {
+                for (int dir = 0; dir < 4; ++dir) {
+                    int d = (f / 10 + dir) & 3;
+                    if (mazeGen.maze.HasWall(player.cellX, player.cellY, d)) continue;
+                    player.cellX += (d == WALL_RIGHT) - (d == WALL_LEFT);
+                    player.cellY += (d == WALL_BOTTOM) - (d == WALL_TOP);
+                    player.position = glm::vec2((player.cellX + 0.5f) * cellSize, (player.cellY + 0.5f) * cellSize);
+                    break;
+                }
+            }
+            field.Update(mazeGen.maze, player.cellX, player.cellY);
+            seconds += MeasureSeconds([&]() {
+                swarm.Update(dt, player.position.x, player.position.y, player.cellX, player.cellY, mazeGen, cellSize, &field);
+            });
+            scalar += swarm.LastScalarCount();
+        }
+
+        // 位置与路点必须在同一格或相邻且相通的两格中
+        size_t chasing = 0;
+        for (size_t i = 0; i < swarm.Size(); ++i) {
+            int cx = static_cast<int>(swarm.posX[i] / cellSize), cy = static_cast<int>(swarm.posY[i] / cellSize);
+            int tx = static_cast<int>(swarm.targetX[i] / cellSize), ty = static_cast<int>(swarm.targetY[i] / cellSize);
+            int dx = tx - cx, dy = ty - cy;
+            bool valid = (dx == 0 && dy == 0)
+                || (std::abs(dx) + std::abs(dy) == 1 && !mazeGen.maze.HasWall(cx, cy, dx == 1 ? WALL_RIGHT : dx == -1 ? WALL_LEFT : dy == 1 ? WALL_BOTTOM : WALL_TOP));
+            ok = ok && valid;
+            chasing += swarm.IsChasing(i);
+        }
+
+        std::cout << std::setw(7) << monsterCount << " monsters  swarm " << std::fixed << std::setprecision(3)
+                  << seconds / frames * 1000.0 << " ms/frame  scalar path " << std::setprecision(1)
+                  << static_cast<double>(scalar) / frames << "/frame  chasing " << chasing
+                  << "  " << (ok ? "OK" : "FAILED") << "\n";
+    }
+
+    // 对照: 同样 10k 个怪物用 Monster::Update 逐个更新
+    {
+        const int monsterCount = 10000, aosFrames = 10;
+        std::vector<Monster> monsters;
+        monsters.reserve(monsterCount);
+        std::mt19937 rng(3u);
+        for (int i = 0; i < monsterCount; ++i) {
+            monsters.emplace_back((rng() % size + 0.5f) * cellSize, (rng() % size + 0.5f) * cellSize);
+        }
+        Player player(size / 2, size / 2, cellSize);
+        field.Update(mazeGen.maze, player.cellX, player.cellY);
+        double seconds = MeasureSeconds([&]() {
+            for (int f = 0; f < aosFrames; ++f) {
+                for (auto& monster : monsters) monster.Update(dt, player, mazeGen, cellSize, &field);
+            }
+        });
+        std::cout << "  10000 monsters  std::vector<Monster> " << std::fixed << std::setprecision(3)
+                  << seconds / aosFrames * 1000.0 << " ms/frame\n";
+    }
+    return ok;
+}
+
+// 任务系统: 先检查 ParallelFor 对每个下标恰好执行一次，再测 1k / 10k / 100k 个 Monster 并行更新的扩展性，
+// 并检查合并后的事件列表与按最终状态逐个重新计算的结果一致 (返回是否全部通过)
+static bool RunJobSystemBenchmark() {
+    const int size = 256;
+    const float cellSize = 25.0f;
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::cout << "--- Job system: parallel Monster::Update (" << hardwareThreads << " hardware threads) ---\n";
+    bool ok = true;
+
+    {
+        JobSystem jobs;
+        std::vector<uint8_t> hits(1 << 20);
+        for (int round = 0; round < 20; ++round) {
+            std::fill(hits.begin(), hits.end(), 0);
+            jobs.ParallelFor(hits.size(), 1000 + round * 997, [&](size_t begin, size_t end, int) {
+                for (size_t i = begin; i < end; ++i) ++hits[i];
+            });
+            ok = ok && std::all_of(hits.begin(), hits.end(), [](uint8_t h) { return h == 1; });
+        }
+        std::cout << "ParallelFor coverage (20 x 1M)  steals " << jobs.StealCount() << "  " << (ok ? "OK" : "FAILED") << "\n";
+    }
+
+    MazeGenerator mazeGen(size, size, 12345u);
+    mazeGen.Generate();
+    mazeGen.BuildTree();
+    mazeGen.BuildPvs();
+    Player player(size / 2, size / 2, cellSize);
+    FlowField field;
+    field.Update(mazeGen.maze, player.cellX, player.cellY);
+    const float dt = 1.0f / 60.0f;
+
+    std::vector<int> threadCounts = { 1 };
+    for (int t = 2; t < hardwareThreads; t *= 2) threadCounts.push_back(t);
+    if (hardwareThreads > 1) threadCounts.push_back(hardwareThreads);
+
+    const int counts[] = { 1000, 10000, 100000 };
+    for (int monsterCount : counts) {
+        std::vector<Monster> initial;
+        initial.reserve(monsterCount);
+        std::mt19937 rng(5u);
+        for (int i = 0; i < monsterCount; ++i) {
+            initial.emplace_back((rng() % size + 0.5f) * cellSize, (rng() % size + 0.5f) * cellSize);
+        }
+        const int frames = std::max(2, 20000 / monsterCount);
+
+        double baseline = 0.0;
+        for (int threads : threadCounts) {
+            JobSystem jobs(threads);
+            MonsterUpdater updater(jobs);
+            std::vector<Monster> monsters(initial);
+            double seconds = MeasureSeconds([&]() {
+                for (int f = 0; f < frames; ++f) updater.Update(monsters, dt, player, mazeGen, cellSize, &field, false);
+            });
+            if (threads == 1) baseline = seconds;
+
+            // 事件必须与最终状态一致且按怪物下标排序
+            std::vector<MonsterEvent> expected;
+            for (size_t i = 0; i < monsters.size(); ++i) {
+                float distance = glm::distance(monsters[i].position, player.position);
+                if (monsters[i].visible && distance < monsters[i].detectionRange) expected.push_back({ static_cast<uint32_t>(i), MonsterEvent::ALERT });
+                if (!monsters[i].frozen && distance < player.radius + monsters[i].radius) expected.push_back({ static_cast<uint32_t>(i), MonsterEvent::CONTACT });
+            }
+            const std::vector<MonsterEvent>& events = updater.Events();
+            bool match = events.size() == expected.size() && std::equal(events.begin(), events.end(), expected.begin(),
+                [](const MonsterEvent& a, const MonsterEvent& b) { return a.monster == b.monster && a.type == b.type; });
+            ok = ok && match;
+
+            std::cout << std::setw(7) << monsterCount << " monsters  " << std::setw(2) << threads << " threads  "
+                      << std::fixed << std::setprecision(3) << seconds / frames * 1000.0 << " ms/frame  speedup "
+                      << std::setprecision(2) << baseline / seconds << "x  events " << events.size()
+                      << "  steals " << jobs.StealCount() << "  " << (match ? "OK" : "FAILED") << "\n";
+        }
+    }
+    return ok;
+}
+
+// AI LOD: 10k 个怪物散布在 256 x 256 的迷宫中，比较每帧全部完整更新与分档更新的耗时，
+// 并检查近处每帧都更新、不限预算时中距离/远处在各自的间隔内都轮到 (返回是否全部通过)
+static bool RunAiLodBenchmark() {
+    const int size = 256, monsterCount = 10000, frames = 60;
+    const float cellSize = 25.0f, dt = 1.0f / 60.0f;
+    std::cout << "--- AI LOD scheduler (" << monsterCount << " monsters, " << size << " x " << size << ") ---\n";
+    MazeGenerator mazeGen(size, size, 12345u);
+    mazeGen.Generate();
+    mazeGen.BuildTree();
+    mazeGen.BuildPvs();
+    Player player(size / 2, size / 2, cellSize);
+    FlowField field;
+    field.Update(mazeGen.maze, player.cellX, player.cellY);
+
+    std::vector<Monster> initial;
+    initial.reserve(monsterCount);
+    std::mt19937 rng(9u);
+    for (int i = 0; i < monsterCount; ++i) {
+        initial.emplace_back((rng() % size + 0.5f) * cellSize, (rng() % size + 0.5f) * cellSize);
+    }
+
+    JobSystem jobs;
+    MonsterUpdater updater(jobs);
+    std::vector<Monster> monsters(initial);
+    const int fullFrames = 10;
+    double fullSeconds = MeasureSeconds([&]() {
+        for (int f = 0; f < fullFrames; ++f) updater.Update(monsters, dt, player, mazeGen, cellSize, &field, false);
+    }) / fullFrames;
+    std::cout << "every monster every frame  " << std::fixed << std::setprecision(3) << fullSeconds * 1000.0 << " ms/frame\n";
+
+    bool ok = true;
+    const float budgets[] = { 0.0f, 2.0f, 0.5f };
+    for (float budgetMs : budgets) {
+        AiLodSettings settings;
+        settings.budgetMs = budgetMs;
+        AiLodScheduler scheduler(settings);
+        std::vector<Monster> lodMonsters(initial); // Monster 含 const 成员，不能整体赋值
+        std::vector<int> lastUpdate(monsterCount, -1), longestGap(monsterCount, 0);
+        size_t updated[AiLodScheduler::TIER_COUNT] = {}, deferred = 0;
+        bool nearEveryFrame = true;
+        double worstFrame = 0.0, totalSeconds = 0.0;
+        for (int f = 0; f < frames; ++f) {
+            double seconds = MeasureSeconds([&]() {
+                scheduler.Schedule(lodMonsters, player, dt);
+                updater.Update(lodMonsters, scheduler, player, mazeGen, cellSize, &field, false);
+            });
+            totalSeconds += seconds;
+            if (f >= 10) worstFrame = std::max(worstFrame, seconds); // 前几帧用于让耗时估计收敛
+            const AiLodScheduler::Stats& stats = scheduler.LastStats();
+            nearEveryFrame = nearEveryFrame && stats.updated[AiLodScheduler::TIER_NEAR] == stats.inTier[AiLodScheduler::TIER_NEAR];
+            for (int t = 0; t < AiLodScheduler::TIER_COUNT; ++t) updated[t] += stats.updated[t];
+            deferred += stats.deferred;
+            for (const AiLodScheduler::Task& task : scheduler.Tasks()) {
+                if (task.tier != AiLodScheduler::TIER_NEAR) {
+                    longestGap[task.monster] = std::max(longestGap[task.monster], f - lastUpdate[task.monster]);
+                }
+                lastUpdate[task.monster] = f;
+            }
+        }
+        // 不限预算时，中距离/远处的怪物最迟在各自的间隔内轮到一次
+        bool intervalsKept = true;
+        if (budgetMs <= 0.0f) {
+            for (int i = 0; i < monsterCount; ++i) {
+                intervalsKept = intervalsKept && longestGap[i] <= std::max(settings.midInterval, settings.farInterval);
+            }
+        }
+        // 每个怪物仍在迷宫范围内
+        bool inside = std::all_of(lodMonsters.begin(), lodMonsters.end(), [&](const Monster& m) {
+            return m.position.x >= 0.0f && m.position.y >= 0.0f && m.position.x <= size * cellSize && m.position.y <= size * cellSize;
+        });
+        bool pass = nearEveryFrame && intervalsKept && inside;
+        ok = ok && pass;
+
+        const AiLodScheduler::Stats& stats = scheduler.LastStats();
+        std::cout << "budget " << std::setprecision(1) << std::setw(4) << budgetMs << " ms  " << std::setprecision(3)
+                  << totalSeconds / frames * 1000.0 << " ms/frame (worst " << worstFrame * 1000.0 << ")  speedup "
+                  << std::setprecision(1) << fullSeconds * frames / totalSeconds << "x\n"
+                  << "    tiers near/mid/far/sleep " << stats.inTier[AiLodScheduler::TIER_NEAR] << "/" << stats.inTier[AiLodScheduler::TIER_MID]
+                  << "/" << stats.inTier[AiLodScheduler::TIER_FAR] << "/" << stats.inTier[AiLodScheduler::TIER_SLEEP]
+                  << "  updates per frame " << std::setprecision(1) << static_cast<double>(updated[AiLodScheduler::TIER_NEAR]) / frames
+                  << "/" << static_cast<double>(updated[AiLodScheduler::TIER_MID]) / frames
+                  << "/" << static_cast<double>(updated[AiLodScheduler::TIER_FAR]) / frames
+                  << "  deferred " << deferred << "  " << (pass ? "OK" : "FAILED") << "\n";
+    }
+    return ok;
+}
+
+// 分块世界: 沿一个方向长距离行走，内存应保持在上限以内
+static void RunChunkedWorldBenchmark() {
+    std::cout << "--- Chunked world (LRU, 1 MB budget) ---\n";
+    ChunkedMaze world(12345u, 1024 * 1024);
+    const int steps = 200000;
+    int x = 0, y = 0;
+    size_t blocked = 0;
+    double seconds = MeasureSeconds([&]() {
+        for (int i = 0; i < steps; ++i) {
+            // 每走一步查询当前格四面墙，然后斜向前进
+            for (int side = 0; side < 4; ++side) blocked += world.HasWall(x, y, side);
+            if (i & 1) ++x; else ++y;
+        }
+    });
+    std::cout << "walked to (" << x << ", " << y << ")"
+              << "  " << std::fixed << std::setprecision(2) << steps * 4.0 / seconds / 1e6 << " Mqueries/s"
+              << "  chunks generated " << world.GeneratedChunks()
+              << "  loaded " << world.LoadedChunks()
+              << "  " << world.MemoryBytes() / 1024 << " KB"
+              << "  blocked " << blocked << "\n";
+}
+
+// 迷宫文件: 保存与内存映射加载的耗时，并逐字校验往返结果 (返回是否一致)
+static bool RunMazeFileBenchmark() {
+    const int size = 4096;
+    const char* path = "bench_maze.ddmz";
+    std::cout << "--- Maze file save / mmap load " << size << " x " << size << " ---\n";
+    MazeGenerator source(size, size, 12345u);
+    source.Generate();
+
+    bool saved = false, loaded = false;
+    double saveSeconds = MeasureSeconds([&]() { saved = source.Save(path); });
+    MazeGenerator target(1, 1, 0u);
+    double loadSeconds = MeasureSeconds([&]() { loaded = target.Load(path); });
+
+    bool same = saved && loaded && target.width == size && target.height == size
+        && target.seed == source.seed && target.maze.IsExternal();
+    for (int y = 0; same && y < size; ++y) {
+        same = std::equal(source.maze.RowWords(y), source.maze.RowWords(y) + source.maze.WordsPerRow(),
+                          static_cast<const MazeGrid&>(target.maze).RowWords(y));
+    }
+    // 修改后应脱离映射，且不影响文件内容
+    if (same) {
+        target.maze.RemoveWall(0, 0, WALL_RIGHT);
+        same = !target.maze.IsExternal();
+    }
+
+    std::cout << "save " << std::fixed << std::setprecision(3) << saveSeconds * 1000.0 << " ms"
+              << "  load " << loadSeconds * 1000.0 << " ms"
+              << "  " << source.maze.MemoryBytes() / 1024 << " KB"
+              << "  round trip " << (same ? "OK" : "FAILED") << "\n";
+    target = MazeGenerator(1, 1, 0u); // 先释放映射再删除文件
+    std::remove(path);
+    return same;
+}
+
+// 迷宫墙壁网格 (渲染的 CPU 部分，不需要 OpenGL 上下文): 原来每帧逐格生成顶点 (内墙两侧各一次)，
+// 现在每次生成迷宫后建立一次去重、合并后的线段网格；检查两者覆盖的单位墙段完全相同 (返回是否正确)
+static bool RunMazeMeshBenchmark() {
+    std::cout << "--- Maze wall mesh (per-frame rebuild vs cached) ---\n";
+    const int sizes[] = { 20, 512, 2048 };
+    const float cellSize = 25.0f;
+    bool allOk = true;
+    for (int size : sizes) {
+        MazeGenerator mazeGen(size, size, 12345u);
+        mazeGen.Generate();
+
+        // 原 Renderer::DrawMaze 每帧的顶点生成
+        std::vector<float> perFrame;
+        auto rebuildPerFrame = [&]() {
+            perFrame.clear();
+            for (int y = 0; y < size; ++y) {
+                for (int x = 0; x < size; ++x) {
+                    float x1 = x * cellSize, x2 = (x + 1) * cellSize, y1 = y * cellSize, y2 = (y + 1) * cellSize;
+                    if (mazeGen.maze.HasWall(x, y, WALL_TOP)) perFrame.insert(perFrame.end(), { x1, y1, 0.8f, 0.8f, 0.8f, x2, y1, 0.8f, 0.8f, 0.8f });
+                    if (mazeGen.maze.HasWall(x, y, WALL_RIGHT)) perFrame.insert(perFrame.end(), { x2, y1, 0.8f, 0.8f, 0.8f, x2, y2, 0.8f, 0.8f, 0.8f });
+                    if (mazeGen.maze.HasWall(x, y, WALL_BOTTOM)) perFrame.insert(perFrame.end(), { x2, y2, 0.8f, 0.8f, 0.8f, x1, y2, 0.8f, 0.8f, 0.8f });
+                    if (mazeGen.maze.HasWall(x, y, WALL_LEFT)) perFrame.insert(perFrame.end(), { x1, y2, 0.8f, 0.8f, 0.8f, x1, y1, 0.8f, 0.8f, 0.8f });
+                }
+            }
+        };
+        const int frames = size <= 512 ? 20 : 3;
+        rebuildPerFrame();
+        double perFrameSeconds = MeasureSeconds([&]() { for (int f = 0; f < frames; ++f) rebuildPerFrame(); }) / frames;
+        std::vector<float> cached;
+        double buildSeconds = MeasureSeconds([&]() { BuildMazeWallLines(mazeGen.maze, cellSize, cached); });
+
+        // 把两组线段拆成单位墙段 (水平/竖直, 格线坐标) 后比较
+        auto unitWalls = [&](const std::vector<float>& vertices) {
+            std::vector<uint64_t> walls;
+            for (size_t v = 0; v + 9 < vertices.size(); v += 10) {
+                int x1 = static_cast<int>(std::lround(vertices[v] / cellSize)), y1 = static_cast<int>(std::lround(vertices[v + 1] / cellSize));
+                int x2 = static_cast<int>(std::lround(vertices[v + 5] / cellSize)), y2 = static_cast<int>(std::lround(vertices[v + 6] / cellSize));
+                bool horizontal = y1 == y2;
+                int from = horizontal ? std::min(x1, x2) : std::min(y1, y2), to = horizontal ? std::max(x1, x2) : std::max(y1, y2);
+                for (int k = from; k < to; ++k) {
+                    uint64_t x = horizontal ? k : x1, y = horizontal ? y1 : k;
+                    walls.push_back(static_cast<uint64_t>(horizontal) << 62 | x << 31 | y);
+                }
+            }
+            std::sort(walls.begin(), walls.end());
+            walls.erase(std::unique(walls.begin(), walls.end()), walls.end());
+            return walls;
+        };
+        bool ok = unitWalls(perFrame) == unitWalls(cached);
+        allOk = allOk && ok;
+
+        const size_t perFrameVertices = perFrame.size() / 5, cachedVertices = cached.size() / 5;
+        std::cout << std::setw(5) << size << " x " << std::setw(5) << size
+                  << "  per-frame rebuild " << std::fixed << std::setprecision(3) << perFrameSeconds * 1000.0 << " ms/frame, "
+                  << perFrameVertices << " vertices (" << perFrameVertices * 5 * sizeof(float) / 1024 << " KB uploaded/frame)"
+                  << "  cached: built once in " << buildSeconds * 1000.0 << " ms, " << cachedVertices << " vertices ("
+                  << std::setprecision(1) << static_cast<double>(perFrameVertices) / cachedVertices << "x fewer), 0 ms/frame"
+                  << "  walls " << (ok ? "OK" : "FAILED") << "\n";
+    }
+    return allOk;
+}
+
+// 迷宫墙壁纹理 (CPU 部分): 每格一个字节的墙壁掩码与线段网格的上传量对比，以及局部改动时只需上传的矩形。
+// 检查掩码与 HasWall 一致、相同掩码没有脏矩形、拆一面墙只产生包含相邻两格的小矩形 (返回是否正确)
+static bool RunMazeWallTextureBenchmark() {
+    std::cout << "--- Maze wall texture (bitmask upload vs line mesh) ---\n";
+    const int sizes[] = { 20, 512, 2048 };
+    const float cellSize = 25.0f;
+    bool allOk = true;
+    for (int size : sizes) {
+        MazeGenerator mazeGen(size, size, 12345u);
+        mazeGen.Generate();
+
+        std::vector<float> lines;
+        BuildMazeWallLines(mazeGen.maze, cellSize, lines);
+        std::vector<uint8_t> masks;
+        double maskSeconds = MeasureSeconds([&]() { BuildMazeWallMasks(mazeGen.maze, masks); });
+        bool ok = masks.size() == static_cast<size_t>(size) * size;
+        for (int y = 0; ok && y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                for (int side = 0; side < 4; ++side) {
+                    if (((masks[static_cast<size_t>(y) * size + x] >> side) & 1) != (mazeGen.maze.HasWall(x, y, side) ? 1 : 0)) ok = false;
+                }
+            }
+        }
+
+        // 没有变化时不上传；在迷宫中间拆一面墙后只上传相邻两格
+        int x0, y0, x1, y1;
+        std::vector<uint8_t> edited = masks;
+        ok = ok && !FindDirtyRect(masks, edited, size, size, x0, y0, x1, y1);
+        int cx = size / 2;
+        const int cy = size / 2;
+        while (cx + 2 < size && !mazeGen.maze.HasWall(cx, cy, WALL_RIGHT)) ++cx;
+        MazeGenerator editedGen(size, size, 12345u);
+        editedGen.Generate();
+        editedGen.maze.RemoveWall(cx, cy, WALL_RIGHT);
+        editedGen.maze.RemoveWall(cx + 1, cy, WALL_LEFT);
+        BuildMazeWallMasks(editedGen.maze, edited);
+        bool dirty = false;
+        double diffSeconds = MeasureSeconds([&]() { dirty = FindDirtyRect(masks, edited, size, size, x0, y0, x1, y1); });
+        ok = ok && dirty && x0 == cx && x1 == cx + 2 && y0 == cy && y1 == cy + 1;
+        allOk = allOk && ok;
+
+        const size_t lineBytes = lines.size() * sizeof(float);
+        std::cout << std::setw(5) << size << " x " << std::setw(5) << size
+                  << "  masks built in " << std::fixed << std::setprecision(3) << maskSeconds * 1000.0 << " ms, "
+                  << masks.size() / 1024 << " KB texture vs " << lineBytes / 1024 << " KB line mesh ("
+                  << std::setprecision(1) << static_cast<double>(lineBytes) / masks.size() << "x smaller)"
+                  << "  one-wall edit: diff " << std::setprecision(3) << diffSeconds * 1000.0 << " ms, "
+                  << (dirty ? static_cast<size_t>(x1 - x0) * (y1 - y0) : 0) << " bytes uploaded"
+                  << "  masks " << (ok ? "OK" : "FAILED") << "\n";
+    }
+    return allOk;
+}
+
+// 关卡切换: 主线程同步生成的耗时 vs. 后台生成后主线程只做交换的耗时
+static void RunLevelSwapBenchmark() {
+    std::cout << "--- Level reset: synchronous build vs background build + swap ---\n";
+    const int sizes[] = { 20, 512, 2048 };
+    const float cellSize = 25.0f;
+    for (int size : sizes) {
+        double syncSeconds = MeasureSeconds([&]() { BuildLevel(size, size, cellSize, 12345u); });
+
+        MazeGenerator mazeGen(size, size, 1u);
+        std::vector<Monster> monsters;
+        std::vector<Collectible> collectibles;
+        LevelBuilder builder;
+        builder.Start(size, size, cellSize, 12345u);
+        while (!builder.IsReady()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::unique_ptr<Level> level;
+        double swapSeconds = MeasureSeconds([&]() {
+            level = builder.Take();
+            std::swap(mazeGen, level->mazeGen);
+            monsters.swap(level->monsters);
+            collectibles.swap(level->collectibles);
+            level.reset(); // 旧关卡也在主线程上释放
+        });
+        std::cout << std::setw(5) << size << " x " << std::setw(5) << size
+                  << "  sync build " << std::fixed << std::setprecision(3) << syncSeconds * 1000.0 << " ms"
+                  << "  swap " << swapSeconds * 1000.0 << " ms on main thread\n";
+    }
+}
+
+int RunBenchmarks(int /*argc*/, char** /*argv*/) {
+    RunMazeGenerationBenchmark();
+    RunParallelGenerationBenchmark();
+    RunAlgorithmComparisonBenchmark();
+    RunEllerStreamingBenchmark();
+    RunChunkedWorldBenchmark();
+    RunLevelSwapBenchmark();
+    bool ok = RunMazeFileBenchmark();
+    ok = RunMazeTreeBenchmark() && ok;
+    ok = RunPathfindingBenchmark() && ok;
+    ok = RunHierarchicalPathfindingBenchmark() && ok;
+    ok = RunCorridorGraphBenchmark() && ok;
+    ok = RunPathServiceBenchmark() && ok;
+    ok = RunPathCacheBenchmark() && ok;
+    ok = RunFlowFieldBenchmark() && ok;
+    ok = RunLineOfSightBenchmark() && ok;
+    ok = RunPvsBenchmark() && ok;
+    ok = RunMonsterSwarmBenchmark() && ok;
+    ok = RunJobSystemBenchmark() && ok;
+    ok = RunAiLodBenchmark() && ok;
+    ok = RunMazeMeshBenchmark() && ok;
+    ok = RunMazeWallTextureBenchmark() && ok;
+    return ok ? 0 : 1;
+}
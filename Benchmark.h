@@ -0,0 +1,5 @@
+#pragma once
+
+// 性能测试入口 (命令行: dark_deception --bench)
+// 不创建窗口，只运行与渲染无关的基准测试并把结果打印到控制台
+int RunBenchmarks(int argc, char** argv);
@@ -0,0 +1,127 @@
+#pragma once
+#include <unordered_map>
+#include <list>
+#include <cstdint>
+#include <cstddef>
+#include "MazeGenerator.h"
+
+// 分块的无限迷宫
+// 世界被划分为 CHUNK_SIZE x CHUNK_SIZE 的区块，每个区块在第一次被访问时
+// 由 (世界种子, 区块 x, 区块 y) 的哈希作为种子单独生成一个完美迷宫。
+// 相邻区块之间的边界上各开一扇门，门的位置同样只取决于哈希，
+// 因此查询边界墙时不需要加载邻居区块，整个世界始终连通。
+// 已加载的区块按 LRU 淘汰，总内存不超过 memoryBudget。
+class ChunkedMaze {
+public:
+    static const int CHUNK_SIZE = 64;
+
+    explicit ChunkedMaze(unsigned int worldSeed, size_t memoryBudgetBytes = 4 * 1024 * 1024)
+        : seed(worldSeed), memoryBudget(memoryBudgetBytes) {}
+
+    // 世界坐标 (x, y) 的 side 方向是否有墙，坐标可以是任意整数
+    bool HasWall(int x, int y, int side) {
+        int cx = FloorDiv(x), cy = FloorDiv(y);
+        int lx = x - cx * CHUNK_SIZE, ly = y - cy * CHUNK_SIZE;
+
+        // 区块边界: 只有门所在的那一格是通的
+        switch (side) {
+        case WALL_TOP:
+            if (ly == 0) return lx != SouthDoor(cx, cy - 1);
+            break;
+        case WALL_RIGHT:
+            if (lx == CHUNK_SIZE - 1) return ly != EastDoor(cx, cy);
+            break;
+        case WALL_BOTTOM:
+            if (ly == CHUNK_SIZE - 1) return lx != SouthDoor(cx, cy);
+            break;
+        case WALL_LEFT:
+            if (lx == 0) return ly != EastDoor(cx - 1, cy);
+            break;
+        }
+        return GetChunk(cx, cy).HasWall(lx, ly, side);
+    }
+
+    // 调整内存上限 (超出部分立即淘汰)
+    void SetMemoryBudget(size_t bytes) {
+        memoryBudget = bytes;
+        EvictToBudget();
+    }
+
+    size_t LoadedChunks() const { return chunks.size(); }
+    size_t MemoryBytes() const { return chunks.size() * ChunkBytes(); }
+    size_t GeneratedChunks() const { return generatedCount; } // 累计生成次数 (含被淘汰后重新生成)
+
+private:
+    struct Chunk {
+        MazeGrid grid;
+        std::list<uint64_t>::iterator lruIt;
+    };
+
+    unsigned int seed;
+    size_t memoryBudget;
+    std::unordered_map<uint64_t, Chunk> chunks;
+    std::list<uint64_t> lru; // 队首为最近使用
+    uint64_t lastKey = 0;
+    const MazeGrid* lastGrid = nullptr; // 上次访问的区块 (连续查询同一区块时跳过哈希表与 LRU 更新)
+    size_t generatedCount = 0;
+
+    static int FloorDiv(int v) {
+        return (v >= 0 ? v : v - (CHUNK_SIZE - 1)) / CHUNK_SIZE;
+    }
+
+    static uint64_t ChunkKey(int cx, int cy) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+    }
+
+    // 每个区块的大致内存: 墙壁位图 + 哈希表/链表节点
+    static size_t ChunkBytes() {
+        static const size_t bytes = MazeGrid(CHUNK_SIZE, CHUNK_SIZE).MemoryBytes() + sizeof(Chunk) + sizeof(uint64_t) * 4;
+        return bytes;
+    }
+
+    // splitmix64 混合 (世界种子, 区块坐标, 用途)
+    uint32_t Hash(int cx, int cy, uint32_t salt) const {
+        uint64_t h = (static_cast<uint64_t>(seed) << 32) ^ ChunkKey(cx, cy) ^ (static_cast<uint64_t>(salt) * 0x9E3779B97F4A7C15ull);
+        h += 0x9E3779B97F4A7C15ull;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        h ^= h >> 31;
+        return static_cast<uint32_t>(h);
+    }
+
+    // 区块 (cx, cy) 与右侧区块之间的门所在的行
+    int EastDoor(int cx, int cy) const { return static_cast<int>(Hash(cx, cy, 'E') % CHUNK_SIZE); }
+    // 区块 (cx, cy) 与下方区块之间的门所在的列
+    int SouthDoor(int cx, int cy) const { return static_cast<int>(Hash(cx, cy, 'S') % CHUNK_SIZE); }
+
+    const MazeGrid& GetChunk(int cx, int cy) {
+        uint64_t key = ChunkKey(cx, cy);
+        if (lastGrid && key == lastKey) return *lastGrid;
+
+        auto it = chunks.find(key);
+        if (it != chunks.end()) {
+            lru.splice(lru.begin(), lru, it->second.lruIt);
+        }
+        else {
+            MazeGenerator gen(CHUNK_SIZE, CHUNK_SIZE, Hash(cx, cy, 'C'));
+            gen.Generate();
+            lru.push_front(key);
+            it = chunks.emplace(key, Chunk{ std::move(gen.maze), lru.begin() }).first;
+            ++generatedCount;
+            EvictToBudget();
+        }
+        lastKey = key;
+        lastGrid = &it->second.grid;
+        return *lastGrid;
+    }
+
+    // 淘汰最久未使用的区块，直到内存不超过上限 (至少保留一个区块)
+    void EvictToBudget() {
+        while (chunks.size() > 1 && MemoryBytes() > memoryBudget) {
+            uint64_t victim = lru.back();
+            lru.pop_back();
+            chunks.erase(victim);
+            if (victim == lastKey) lastGrid = nullptr;
+        }
+    }
+};
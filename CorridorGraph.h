@@ -0,0 +1,476 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include "MazeGrid.h"
+
+// 迷宫的走廊图
+// 回溯法生成的迷宫里绝大多数格子都是只有两个开口的走廊。走廊图只把岔路口和死胡同 (开口数不等于 2 的格子) 作为节点，
+// 两个节点之间的一段走廊是一条边，记录长度 (步数) 与沿途的格子 (从 a 到 b 的顺序，不含两端节点)。
+// 每个格子还记录自己是哪个节点，或在哪条边上的第几格，查询时可以 O(1) 把任意格子接入图中。
+// 寻路与距离场都只在节点上搜索，需要走动时才展开回格子 (见 CorridorPathfinder / CorridorFlowField)。
+// Build 对迷宫扫描一遍；迷宫改变后需要重新 Build。格子编号为 y * width + x。
+class CorridorGraph {
+public:
+    struct Edge {
+        uint32_t a, b;      // 两端节点
+        uint32_t length;    // a 到 b 的步数 (= 中间格子数 + 1)
+        uint32_t firstCell; // 中间格子在 edgeCells 中的起始下标
+    };
+
+    // 节点的一条关联边: edge 为边的编号，fromA 表示本节点是该边的 a 端
+    struct Incidence {
+        uint32_t edge;
+        bool fromA;
+    };
+
+    static constexpr uint32_t NODE_FLAG = 0x80000000u; // location 的最高位: 该格是节点
+
+    void Build(const MazeGrid& grid) {
+        Clear();
+        width = grid.width;
+        height = grid.height;
+        const size_t cellCount = static_cast<size_t>(width) * height;
+        location.assign(cellCount, UNASSIGNED);
+        offset.assign(cellCount, 0);
+
+        // 1. 开口数不等于 2 的格子是节点
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                int openings = 0;
+                for (int dir = 0; dir < 4; ++dir) openings += !grid.HasWall(x, y, dir);
+                if (openings != 2) AddNode(static_cast<uint32_t>(y * width + x));
+            }
+        }
+        // 2. 从每个节点沿各个开口走到下一个节点；没有节点的环 (只出现在非完美迷宫中) 任取一格作节点后同样处理
+        for (uint32_t n = 0; n < nodeCells.size(); ++n) WalkFrom(grid, n);
+        for (uint32_t cell = 0; cell < cellCount; ++cell) {
+            if (location[cell] != UNASSIGNED) continue;
+            AddNode(cell);
+            WalkFrom(grid, static_cast<uint32_t>(nodeCells.size() - 1));
+        }
+
+        // 3. 每个节点的关联边整理成 CSR
+        incidenceStart.assign(nodeCells.size() + 1, 0);
+        for (const Edge& edge : edges) {
+            ++incidenceStart[edge.a + 1];
+            ++incidenceStart[edge.b + 1];
+        }
+        for (size_t n = 1; n < incidenceStart.size(); ++n) incidenceStart[n] += incidenceStart[n - 1];
+        incidences.resize(edges.size() * 2);
+        std::vector<uint32_t> fill(incidenceStart.begin(), incidenceStart.end() - 1);
+        for (uint32_t e = 0; e < edges.size(); ++e) {
+            incidences[fill[edges[e].a]++] = Incidence{ e, true };
+            incidences[fill[edges[e].b]++] = Incidence{ e, false };
+        }
+    }
+
+    // 释放走廊图
+    void Clear() {
+        std::vector<uint32_t>().swap(nodeCells);
+        std::vector<Edge>().swap(edges);
+        std::vector<uint32_t>().swap(edgeCells);
+        std::vector<uint32_t>().swap(incidenceStart);
+        std::vector<Incidence>().swap(incidences);
+        std::vector<uint32_t>().swap(location);
+        std::vector<uint32_t>().swap(offset);
+        width = height = 0;
+        version = NextVersion();
+    }
+
+    // 走廊图是否与给定尺寸的迷宫对应
+    bool IsBuilt(int w, int h) const {
+        return !location.empty() && w == width && h == height;
+    }
+
+    // 每次 Build / Clear 都换成一个全局唯一的新值，依赖本图的数据 (如 CorridorFlowField) 据此判断是否过期
+    uint32_t Version() const { return version; }
+
+    size_t NodeCount() const { return nodeCells.size(); }
+    size_t EdgeCount() const { return edges.size(); }
+    int NodeCell(uint32_t node) const { return static_cast<int>(nodeCells[node]); }
+    const Edge& GetEdge(uint32_t edge) const { return edges[edge]; }
+
+    // 边的第 i 个中间格子 (0 <= i < length - 1，从 a 端数起)
+    int EdgeCell(uint32_t edge, uint32_t i) const { return static_cast<int>(edgeCells[edges[edge].firstCell + i]); }
+
+    const Incidence* IncidencesBegin(uint32_t node) const { return incidences.data() + incidenceStart[node]; }
+    const Incidence* IncidencesEnd(uint32_t node) const { return incidences.data() + incidenceStart[node + 1]; }
+
+    // 格子在图中的位置: 节点时返回 true 并给出节点编号；否则给出所在的边和到 a 端的步数 (1 .. length - 1)
+    bool Locate(int cell, uint32_t& index, uint32_t& stepsFromA) const {
+        uint32_t value = location[cell];
+        if (value & NODE_FLAG) {
+            index = value & ~NODE_FLAG;
+            stepsFromA = 0;
+            return true;
+        }
+        index = value;
+        stepsFromA = offset[cell] + 1;
+        return false;
+    }
+
+    // 沿边 edge 上到 a 端 steps 步的格子 (0 为 a，length 为 b)
+    int CellAt(uint32_t edge, uint32_t steps) const {
+        const Edge& e = edges[edge];
+        if (steps == 0) return static_cast<int>(nodeCells[e.a]);
+        if (steps >= e.length) return static_cast<int>(nodeCells[e.b]);
+        return static_cast<int>(edgeCells[e.firstCell + steps - 1]);
+    }
+
+    // 把边上从 fromSteps 走到 toSteps (到 a 端的步数) 经过的格子追加到 out (不含起点，含终点)
+    void AppendWalk(uint32_t edge, uint32_t fromSteps, uint32_t toSteps, std::vector<int>& out) const {
+        if (toSteps > fromSteps) {
+            for (uint32_t s = fromSteps + 1; s <= toSteps; ++s) out.push_back(CellAt(edge, s));
+        }
+        else {
+            for (uint32_t s = fromSteps; s-- > toSteps;) out.push_back(CellAt(edge, s));
+        }
+    }
+
+    // 图本身 (节点、边、沿途格子、邻接表) 的字节数，不含逐格的位置表
+    size_t GraphBytes() const {
+        return (nodeCells.capacity() + edgeCells.capacity() + incidenceStart.capacity()) * sizeof(uint32_t)
+            + edges.capacity() * sizeof(Edge) + incidences.capacity() * sizeof(Incidence);
+    }
+    size_t MemoryBytes() const { return GraphBytes() + (location.capacity() + offset.capacity()) * sizeof(uint32_t); }
+
+private:
+    static constexpr uint32_t UNASSIGNED = 0x7FFFFFFFu; // 尚未登记的格子 (不带 NODE_FLAG)
+
+    int width = 0, height = 0;
+    uint32_t version = 0;
+    std::vector<uint32_t> nodeCells;      // 节点所在的格子
+    std::vector<Edge> edges;
+    std::vector<uint32_t> edgeCells;      // 所有边的中间格子，按边连续存放
+    std::vector<uint32_t> incidenceStart; // 每个节点第一条关联边的下标 (CSR)
+    std::vector<Incidence> incidences;
+    std::vector<uint32_t> location;       // 每格: NODE_FLAG | 节点编号，或所在边的编号
+    std::vector<uint32_t> offset;         // 每格: 在所在边中间格子中的下标 (节点为 0)
+
+    static uint32_t NextVersion() {
+        static std::atomic<uint32_t> counter(0);
+        return ++counter;
+    }
+
+    void AddNode(uint32_t cell) {
+        location[cell] = NODE_FLAG | static_cast<uint32_t>(nodeCells.size());
+        nodeCells.push_back(cell);
+    }
+
+    // 从节点 n 沿每个开口走到下一个节点，登记尚未登记的边
+    void WalkFrom(const MazeGrid& grid, uint32_t n) {
+        static const int DX[4] = { 0, 1, 0, -1 };
+        static const int DY[4] = { -1, 0, 1, 0 };
+        const uint32_t start = nodeCells[n];
+        const int sx = static_cast<int>(start % width), sy = static_cast<int>(start / width);
+        for (int dir = 0; dir < 4; ++dir) {
+            if (grid.HasWall(sx, sy, dir)) continue;
+            int x = sx + DX[dir], y = sy + DY[dir];
+            uint32_t cell = static_cast<uint32_t>(y * width + x);
+            if (location[cell] & NODE_FLAG) {
+                // 两个节点直接相邻: 由编号小的一端登记
+                uint32_t other = location[cell] & ~NODE_FLAG;
+                if (n < other) edges.push_back(Edge{ n, other, 1, static_cast<uint32_t>(edgeCells.size()) });
+                continue;
+            }
+            if (location[cell] != UNASSIGNED) continue; // 这段走廊已从另一端登记过
+
+            const uint32_t edgeIndex = static_cast<uint32_t>(edges.size());
+            const uint32_t firstCell = static_cast<uint32_t>(edgeCells.size());
+            int from = (dir + 2) & 3; // 进入当前格的反方向
+            for (;;) {
+                location[cell] = edgeIndex;
+                offset[cell] = static_cast<uint32_t>(edgeCells.size()) - firstCell;
+                edgeCells.push_back(cell);
+                int next = 0;
+                while (next == from || grid.HasWall(x, y, next)) ++next; // 走廊格恰有两个开口，取不是来路的那个
+                x += DX[next];
+                y += DY[next];
+                from = (next + 2) & 3;
+                cell = static_cast<uint32_t>(y * width + x);
+                if (location[cell] & NODE_FLAG) break;
+            }
+            uint32_t length = static_cast<uint32_t>(edgeCells.size()) - firstCell + 1;
+            edges.push_back(Edge{ n, location[cell] & ~NODE_FLAG, length, firstCell });
+        }
+    }
+};
+
+// 走廊图上的 A* 寻路
+// 起点和终点可以在走廊中间: 起点同时接到所在边的两端节点，终点由两端节点各连一条到终点的边。
+// 边的代价是走廊长度，启发函数为曼哈顿距离 (可采纳且一致，结果是最短路径)。
+// 搜索状态在多次搜索之间复用，与 MazePathfinder 一样每个线程各用一个实例。
+class CorridorPathfinder {
+public:
+    // 成功时 outPath 依次为路径上的格子编号 (含起点和终点)，与 MazePathfinder::FindPath 的输出相同
+    // maxExpanded > 0 时最多展开这么多节点，超出时放弃并返回 false
+    bool FindPath(const CorridorGraph& graph, int width, int startX, int startY, int goalX, int goalY, std::vector<int>& outPath,
+                  size_t maxExpanded = 0) {
+        outPath.clear();
+        expanded = 0;
+        const int start = startY * width + startX, goal = goalY * width + goalX;
+        uint32_t startIndex, startSteps, goalIndex, goalSteps;
+        const bool startIsNode = graph.Locate(start, startIndex, startSteps);
+        const bool goalIsNode = graph.Locate(goal, goalIndex, goalSteps);
+        Prepare(static_cast<uint32_t>(graph.NodeCount()));
+        heap.clear();
+
+        // 终点接入: 终点是节点时就是该节点，否则记下所在边两端到终点的步数
+        auto goalCost = [&](uint32_t node, uint32_t& cost) {
+            if (goalIsNode) {
+                cost = 0;
+                return node == goalIndex;
+            }
+            const CorridorGraph::Edge& e = graph.GetEdge(goalIndex);
+            cost = UNREACHED;
+            if (node == e.a) cost = goalSteps;
+            if (node == e.b) cost = std::min(cost, e.length - goalSteps);
+            return cost != UNREACHED;
+        };
+
+        uint32_t bestCost = UNREACHED, bestNode = NONE;
+        bool direct = false; // 起点与终点在同一条边上，直接沿走廊走
+        if (!startIsNode && !goalIsNode && startIndex == goalIndex) {
+            bestCost = static_cast<uint32_t>(std::abs(static_cast<int>(startSteps) - static_cast<int>(goalSteps)));
+            direct = true;
+            heap.push_back({ bestCost, bestCost, GOAL });
+        }
+        if (startIsNode) {
+            Relax(graph, startIndex, 0, NONE, goalX, goalY, width);
+        }
+        else {
+            const CorridorGraph::Edge& e = graph.GetEdge(startIndex);
+            Relax(graph, e.a, startSteps, NONE, goalX, goalY, width);
+            Relax(graph, e.b, e.length - startSteps, NONE, goalX, goalY, width);
+        }
+
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), Greater);
+            HeapEntry top = heap.back();
+            heap.pop_back();
+            if (top.node == GOAL) break;
+            Node& node = nodes[top.node];
+            if (top.g != node.g) continue; // 过期的堆项
+            ++expanded;
+            if (maxExpanded != 0 && expanded > maxExpanded) return false;
+            uint32_t toGoal;
+            if (goalCost(top.node, toGoal) && node.g + toGoal < bestCost) {
+                bestCost = node.g + toGoal;
+                bestNode = top.node;
+                direct = false;
+                heap.push_back({ bestCost, bestCost, GOAL });
+                std::push_heap(heap.begin(), heap.end(), Greater);
+            }
+            for (const CorridorGraph::Incidence* it = graph.IncidencesBegin(top.node); it != graph.IncidencesEnd(top.node); ++it) {
+                const CorridorGraph::Edge& e = graph.GetEdge(it->edge);
+                uint32_t other = it->fromA ? e.b : e.a;
+                Relax(graph, other, node.g + e.length, it->edge * 2 + (it->fromA ? 0u : 1u), goalX, goalY, width);
+            }
+        }
+        if (bestCost == UNREACHED) return false;
+
+        outPath.push_back(start);
+        if (direct) {
+            graph.AppendWalk(startIndex, startSteps, goalSteps, outPath);
+            return true;
+        }
+
+        // 节点链: 从 bestNode 沿入边回溯到第一个节点
+        chain.clear();
+        for (uint32_t n = bestNode; n != NONE; ) {
+            chain.push_back(n);
+            uint32_t via = nodes[n].via;
+            if (via == NONE) break;
+            const CorridorGraph::Edge& e = graph.GetEdge(via / 2);
+            n = (via & 1) ? e.b : e.a; // 入边的另一端
+        }
+        std::reverse(chain.begin(), chain.end());
+
+        // 起点 -> 第一个节点
+        if (!startIsNode) {
+            const CorridorGraph::Edge& e = graph.GetEdge(startIndex);
+            graph.AppendWalk(startIndex, startSteps, chain.front() == e.a && (chain.front() != e.b || startSteps <= e.length - startSteps) ? 0 : e.length, outPath);
+        }
+        // 节点之间沿入边展开
+        for (size_t i = 1; i < chain.size(); ++i) {
+            uint32_t via = nodes[chain[i]].via;
+            uint32_t edge = via / 2;
+            const CorridorGraph::Edge& e = graph.GetEdge(edge);
+            if (via & 1) graph.AppendWalk(edge, e.length, 0, outPath); // 从 b 端走到 a 端
+            else graph.AppendWalk(edge, 0, e.length, outPath);
+        }
+        // 最后一个节点 -> 终点
+        if (!goalIsNode) {
+            const CorridorGraph::Edge& e = graph.GetEdge(goalIndex);
+            bool fromA = bestNode == e.a && (bestNode != e.b || goalSteps <= e.length - goalSteps);
+            graph.AppendWalk(goalIndex, fromA ? 0 : e.length, goalSteps, outPath);
+        }
+        return true;
+    }
+
+    // 上一次搜索展开的节点数
+    size_t LastExpanded() const { return expanded; }
+
+    size_t MemoryBytes() const { return nodes.capacity() * sizeof(Node) + heap.capacity() * sizeof(HeapEntry) + chain.capacity() * sizeof(uint32_t); }
+
+private:
+    static constexpr uint32_t UNREACHED = 0xFFFFFFFFu;
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+    static constexpr uint32_t GOAL = 0xFFFFFFFEu; // 虚拟终点
+
+    struct Node {
+        uint32_t generation; // 所属的搜索编号
+        uint32_t g;          // 起点到此的步数
+        uint32_t via;        // 入边: 边编号 * 2 + (从 b 端进入本节点时为 1)，直接连着起点时为 NONE
+    };
+    struct HeapEntry {
+        uint32_t f, g, node;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<HeapEntry> heap; // 开放集 (惰性删除)
+    std::vector<uint32_t> chain;
+    uint32_t generation = 0;
+    size_t expanded = 0;
+
+    static bool Greater(const HeapEntry& a, const HeapEntry& b) {
+        return a.f > b.f || (a.f == b.f && a.g < b.g);
+    }
+
+    void Prepare(uint32_t nodeCount) {
+        if (nodes.size() < nodeCount) nodes.resize(nodeCount, Node{ 0, 0, NONE });
+        if (++generation == 0) {
+            for (Node& node : nodes) node.generation = 0;
+            generation = 1;
+        }
+    }
+
+    // via 的约定: 沿边从 a 走到 b 进入 b 时为 edge * 2 (+0 表示来自 a 端)，反之为 edge * 2 + 1
+    void Relax(const CorridorGraph& graph, uint32_t n, uint32_t g, uint32_t via, int goalX, int goalY, int width) {
+        Node& node = nodes[n];
+        if (node.generation == generation && node.g <= g) return;
+        node.generation = generation;
+        node.g = g;
+        node.via = via;
+        int cell = graph.NodeCell(n);
+        uint32_t h = static_cast<uint32_t>(std::abs(cell % width - goalX) + std::abs(cell / width - goalY));
+        heap.push_back({ g + h, g, n });
+        std::push_heap(heap.begin(), heap.end(), Greater);
+    }
+};
+
+// 走廊图上的距离场 (FlowField 的压缩版)
+// 目标改变时只在节点上做一次 Dijkstra；任意格子的下一步由它所在的边和两端节点的距离现算，
+// 重建的开销与节点数而不是格子数成正比。
+class CorridorFlowField {
+public:
+    static constexpr uint32_t UNREACHED = 0xFFFFFFFFu;
+
+    // 目标移动到 targetCell 或走廊图重建 (迷宫改变) 时重建，否则不做任何事；返回是否重建
+    bool Update(const CorridorGraph& graph, int targetCell) {
+        if (valid && targetCell == target && graph.Version() == graphVersion) return false;
+        Build(graph, targetCell);
+        return true;
+    }
+
+    void Invalidate() { valid = false; }
+
+    // 格子到目标的步数
+    uint32_t Distance(const CorridorGraph& graph, int cell) const {
+        uint32_t index, steps;
+        if (graph.Locate(cell, index, steps)) return distance[index];
+        const CorridorGraph::Edge& e = graph.GetEdge(index);
+        uint32_t best = std::min(Add(distance[e.a], steps), Add(distance[e.b], e.length - steps));
+        if (!targetIsNode && index == targetIndex) {
+            best = std::min(best, static_cast<uint32_t>(std::abs(static_cast<int>(steps) - static_cast<int>(targetSteps))));
+        }
+        return best;
+    }
+
+    // 朝目标的下一格；已在目标格或不可达时返回 -1
+    int NextCell(const CorridorGraph& graph, int cell) const {
+        if (cell == target) return -1;
+        uint32_t index, steps;
+        int best = -1;
+        uint32_t bestDistance = UNREACHED;
+        auto consider = [&](uint32_t edge, uint32_t nextSteps) {
+            int next = graph.CellAt(edge, nextSteps);
+            uint32_t d = Distance(graph, next);
+            if (d < bestDistance) {
+                bestDistance = d;
+                best = next;
+            }
+        };
+        if (graph.Locate(cell, index, steps)) {
+            for (const CorridorGraph::Incidence* it = graph.IncidencesBegin(index); it != graph.IncidencesEnd(index); ++it) {
+                const CorridorGraph::Edge& e = graph.GetEdge(it->edge);
+                consider(it->edge, it->fromA ? 1 : e.length - 1);
+            }
+        }
+        else {
+            consider(index, steps - 1);
+            consider(index, steps + 1);
+        }
+        return best;
+    }
+
+    size_t RebuildCount() const { return rebuilds; }
+    size_t MemoryBytes() const { return distance.capacity() * sizeof(uint32_t) + heap.capacity() * sizeof(HeapEntry); }
+
+private:
+    struct HeapEntry {
+        uint32_t d, node;
+        bool operator>(const HeapEntry& other) const { return d > other.d; }
+    };
+
+    bool valid = false;
+    int target = -1;
+    uint32_t graphVersion = 0; // 建立距离时走廊图的版本
+    bool targetIsNode = false;
+    uint32_t targetIndex = 0, targetSteps = 0;
+    size_t rebuilds = 0;
+    std::vector<uint32_t> distance; // 每个节点到目标的步数
+    std::vector<HeapEntry> heap;
+
+    static uint32_t Add(uint32_t a, uint32_t b) { return a == UNREACHED ? UNREACHED : a + b; }
+
+    void Push(uint32_t node, uint32_t d) {
+        if (d >= distance[node]) return;
+        distance[node] = d;
+        heap.push_back({ d, node });
+        std::push_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+    }
+
+    void Build(const CorridorGraph& graph, int targetCell) {
+        valid = true;
+        target = targetCell;
+        graphVersion = graph.Version();
+        ++rebuilds;
+        distance.assign(graph.NodeCount(), UNREACHED);
+        heap.clear();
+        targetIsNode = graph.Locate(targetCell, targetIndex, targetSteps);
+        if (targetIsNode) {
+            Push(targetIndex, 0);
+        }
+        else {
+            const CorridorGraph::Edge& e = graph.GetEdge(targetIndex);
+            Push(e.a, targetSteps);
+            Push(e.b, e.length - targetSteps);
+        }
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+            HeapEntry top = heap.back();
+            heap.pop_back();
+            if (top.d != distance[top.node]) continue;
+            for (const CorridorGraph::Incidence* it = graph.IncidencesBegin(top.node); it != graph.IncidencesEnd(top.node); ++it) {
+                const CorridorGraph::Edge& e = graph.GetEdge(it->edge);
+                Push(it->fromA ? e.b : e.a, top.d + e.length);
+            }
+        }
+    }
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// 并查集 (按大小合并 + 路径压缩)
+class DisjointSet {
+public:
+    explicit DisjointSet(size_t n = 0) { Reset(n); }
+
+    // 重置为 n 个独立集合
+    void Reset(size_t n) {
+        parent.resize(n);
+        setSize.assign(n, 1);
+        for (size_t i = 0; i < n; ++i) parent[i] = static_cast<uint32_t>(i);
+    }
+
+    // 查找根节点，并把路径上的节点直接挂到根下
+    uint32_t Find(uint32_t v) {
+        uint32_t root = v;
+        while (parent[root] != root) root = parent[root];
+        while (parent[v] != root) {
+            uint32_t next = parent[v];
+            parent[v] = root;
+            v = next;
+        }
+        return root;
+    }
+
+    // 合并两个集合；已在同一集合时返回 false
+    bool Union(uint32_t a, uint32_t b) {
+        a = Find(a);
+        b = Find(b);
+        if (a == b) return false;
+        if (setSize[a] < setSize[b]) std::swap(a, b);
+        parent[b] = a;
+        setSize[a] += setSize[b];
+        return true;
+    }
+
+    size_t MemoryBytes() const { return (parent.capacity() + setSize.capacity()) * sizeof(uint32_t); }
+
+private:
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> setSize;
+};
@@ -0,0 +1,131 @@
+#pragma once
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <functional>
+#include <algorithm>
+
+// 流式迷宫的一行
+// walls 中每格的位含义与 MazeGrid 相同: bit0 = 右墙, bit1 = 下墙；
+// 上墙就是上一行的下墙，左墙就是左侧格子的右墙。
+struct MazeRow {
+    int y = 0;                  // 行号 (从 0 开始)
+    std::vector<uint8_t> walls; // 每格的右墙/下墙
+
+    bool HasRightWall(int x) const { return walls[x] & 1u; }
+    bool HasBottomWall(int x) const { return (walls[x] >> 1) & 1u; }
+};
+
+// Eller 算法逐行生成迷宫
+// 只保存当前行的集合编号，工作内存为 O(width)，与已生成的行数无关，
+// 因此可以生成任意高度 (甚至无限延伸) 的迷宫。生成的是完美迷宫，
+// 最后一行需要以 last = true 生成，把剩余的集合全部连通并封底。
+class EllerGenerator {
+public:
+    EllerGenerator(int w, unsigned int s) : width(w), rng(s) {
+        sets.assign(width, -1);
+        parent.resize(width);
+        hasDown.resize(width);
+        memberCount.resize(width);
+        pick.resize(width);
+        labelUsed.resize(width);
+        row.walls.resize(width);
+        row.y = -1;
+    }
+
+    int GetWidth() const { return width; }
+
+    // 生成下一行并返回 (返回的引用在下次调用前有效)
+    const MazeRow& NextRow(bool last = false) {
+        ++row.y;
+        assignNewLabels();
+
+        // 1. 水平方向: 随机打通相邻且不属于同一集合的格子 (最后一行必须全部打通)
+        for (int x = 0; x < width; ++x) parent[x] = x;
+        for (int x = 0; x < width; ++x) row.walls[x] = 3; // 右墙 + 下墙
+        for (int x = 0; x + 1 < width; ++x) {
+            int a = find(sets[x]);
+            int b = find(sets[x + 1]);
+            if (a != b && (last || (rng() & 1u))) {
+                row.walls[x] &= ~1u;
+                parent[b] = a;
+            }
+        }
+        for (int x = 0; x < width; ++x) sets[x] = find(sets[x]);
+
+        if (last) {
+            // 最后一行不再向下延伸
+            return row;
+        }
+
+        // 2. 竖直方向: 每个集合至少向下打通一格
+        for (int x = 0; x < width; ++x) {
+            hasDown[x] = 0;
+            memberCount[x] = 0;
+        }
+        for (int x = 0; x < width; ++x) {
+            int label = sets[x];
+            // 蓄水池抽样: 为没有向下通道的集合随机选一个成员作为兜底
+            if (rng() % static_cast<unsigned int>(++memberCount[label]) == 0) pick[label] = x;
+            if (rng() & 1u) {
+                row.walls[x] &= ~2u;
+                hasDown[label] = 1;
+            }
+        }
+        for (int x = 0; x < width; ++x) {
+            int label = sets[x];
+            if (memberCount[label] > 0 && !hasDown[label]) {
+                row.walls[pick[label]] &= ~2u;
+                hasDown[label] = 1;
+            }
+        }
+
+        // 3. 没有向上通道的格子在下一行成为新集合
+        for (int x = 0; x < width; ++x) {
+            if (row.walls[x] & 2u) sets[x] = -1;
+        }
+        return row;
+    }
+
+    // 连续生成 height 行并逐行回调；height <= 0 表示不限行数，直到回调返回 false
+    void Run(int height, const std::function<bool(const MazeRow&)>& onRow) {
+        for (int y = 0; height <= 0 || y < height; ++y) {
+            bool last = height > 0 && y == height - 1;
+            if (!onRow(NextRow(last))) break;
+        }
+    }
+
+private:
+    int width;
+    std::mt19937 rng;
+    MazeRow row;
+    std::vector<int> sets;        // 当前行每格所属集合 (编号范围 0..width-1)
+    std::vector<int> parent;      // 行内合并集合用的并查集
+    std::vector<uint8_t> hasDown; // 集合是否已有向下通道
+    std::vector<int> memberCount; // 集合成员数 (蓄水池抽样用)
+    std::vector<int> pick;        // 集合的兜底向下格
+    std::vector<uint8_t> labelUsed;
+
+    int find(int label) {
+        while (parent[label] != label) {
+            parent[label] = parent[parent[label]];
+            label = parent[label];
+        }
+        return label;
+    }
+
+    // 为新格子分配未被占用的集合编号，集合数不超过 width，编号始终在 0..width-1
+    void assignNewLabels() {
+        std::fill(labelUsed.begin(), labelUsed.end(), 0);
+        for (int x = 0; x < width; ++x) {
+            if (sets[x] >= 0) labelUsed[sets[x]] = 1;
+        }
+        int nextFree = 0;
+        for (int x = 0; x < width; ++x) {
+            if (sets[x] >= 0) continue;
+            while (labelUsed[nextFree]) ++nextFree;
+            labelUsed[nextFree] = 1;
+            sets[x] = nextFree;
+        }
+    }
+};
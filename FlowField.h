@@ -0,0 +1,82 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "MazeGrid.h"
+
+// 朝向目标 (玩家) 的共享流场
+// 目标所在格改变时从目标做一次 BFS，为每格记录 "朝目标走的下一步方向"。
+// 所有追逐的怪物只需查表 (O(1))，每帧的开销与怪物数量无关。
+// 迷宫被替换 (例如换关) 后必须调用 Invalidate。
+class FlowField {
+public:
+    static constexpr uint8_t NO_DIRECTION = 0xFF; // 目标格本身或不可达的格子
+
+    // 目标移动到 (targetX, targetY) 时重建流场，目标未变时不做任何事；返回是否重建
+    bool Update(const MazeGrid& grid, int targetX, int targetY) {
+        if (valid && targetX == goalX && targetY == goalY && grid.width == width && grid.height == height) return false;
+        Build(grid, targetX, targetY);
+        return true;
+    }
+
+    // 强制下次 Update 时重建
+    void Invalidate() { valid = false; }
+
+    // 流场是否对应给定尺寸的迷宫
+    bool IsValid(int w, int h) const { return valid && w == width && h == height; }
+
+    // (x, y) 朝目标的方向 (WALL_TOP..WALL_LEFT，或 NO_DIRECTION)
+    uint8_t Direction(int x, int y) const { return directions[static_cast<size_t>(y) * width + x]; }
+
+    // (x, y) 朝目标的下一格编号 (y * width + x)；没有下一步时返回 -1
+    int NextCell(int x, int y) const {
+        uint8_t dir = Direction(x, y);
+        if (dir == NO_DIRECTION) return -1;
+        return (y + DY[dir]) * width + (x + DX[dir]);
+    }
+
+    int TargetX() const { return goalX; }
+    int TargetY() const { return goalY; }
+    size_t RebuildCount() const { return rebuilds; }
+    size_t MemoryBytes() const { return directions.capacity() + queue.capacity() * sizeof(uint32_t); }
+
+private:
+    static constexpr int DX[4] = { 0, 1, 0, -1 };
+    static constexpr int DY[4] = { -1, 0, 1, 0 };
+
+    int width = 0, height = 0;
+    int goalX = -1, goalY = -1;
+    bool valid = false;
+    size_t rebuilds = 0;
+    std::vector<uint8_t> directions; // 每格 1 字节
+    std::vector<uint32_t> queue;     // BFS 队列 (在多次重建之间复用)
+
+    void Build(const MazeGrid& grid, int targetX, int targetY) {
+        width = grid.width;
+        height = grid.height;
+        goalX = targetX;
+        goalY = targetY;
+        valid = true;
+        ++rebuilds;
+        const size_t cellCount = static_cast<size_t>(width) * height;
+        directions.assign(cellCount, NO_DIRECTION);
+        queue.clear();
+        queue.reserve(cellCount);
+        if (targetX < 0 || targetX >= width || targetY < 0 || targetY >= height) return;
+
+        // 目标格用 NO_DIRECTION 标记，其余格子第一次被访问时记下指回来源格的方向
+        uint32_t goal = static_cast<uint32_t>(targetY * width + targetX);
+        queue.push_back(goal);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            uint32_t cell = queue[head];
+            int x = static_cast<int>(cell % width), y = static_cast<int>(cell / width);
+            for (int dir = 0; dir < 4; ++dir) {
+                if (grid.HasWall(x, y, dir)) continue;
+                uint32_t next = static_cast<uint32_t>((y + DY[dir]) * width + (x + DX[dir]));
+                if (next == goal || directions[next] != NO_DIRECTION) continue;
+                directions[next] = static_cast<uint8_t>((dir + 2) & 3); // 反方向指回 cell
+                queue.push_back(next);
+            }
+        }
+    }
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+// 帧时间探针
+// 每帧调用 Record 记录帧耗时并维护平均值；某个事件 (例如关卡切换) 发生时调用 Mark，
+// 探针会观察之后的若干帧，输出其中最慢的一帧与平均帧时间的对比，用来确认事件没有造成卡顿。
+class FrameTimeProbe {
+public:
+    explicit FrameTimeProbe(int window = 5) : watchWindow(window) {}
+
+    void Record(float deltaTime) {
+        if (watching > 0) {
+            worstFrame = std::max(worstFrame, deltaTime);
+            if (--watching == 0) Report();
+        }
+        else if (deltaTime > 0.0f) {
+            // 指数滑动平均 (只用平稳时段的帧，不让被观察的帧拉高基准)
+            averageFrame = averageFrame <= 0.0f ? deltaTime : averageFrame * 0.95f + deltaTime * 0.05f;
+        }
+    }
+
+    // 标记事件: label 须为字符串常量，eventSeconds 为事件本身在主线程上的耗时
+    void Mark(const char* label, double eventSeconds) {
+        eventLabel = label;
+        eventCost = eventSeconds;
+        worstFrame = 0.0f;
+        watching = watchWindow;
+    }
+
+    float AverageFrame() const { return averageFrame; }
+
+private:
+    int watchWindow;
+    int watching = 0;
+    float averageFrame = 0.0f;
+    float worstFrame = 0.0f;
+    const char* eventLabel = "";
+    double eventCost = 0.0;
+
+    void Report() const {
+        std::cout << "[frame probe] " << eventLabel << ": " << std::fixed << std::setprecision(3)
+                  << eventCost * 1000.0 << " ms on main thread, worst of next " << watchWindow << " frames "
+                  << worstFrame * 1000.0f << " ms (average " << averageFrame * 1000.0f << " ms)\n";
+    }
+};
@@ -0,0 +1,97 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+JobSystem::JobSystem(int threadCount) {
+    if (threadCount <= 0) threadCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int i = 0; i < threadCount; ++i) queues.push_back(std::make_unique<WorkQueue>());
+    for (int i = 1; i < threadCount; ++i) workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grainSize, const RangeFunction& function) {
+    if (count == 0) return;
+    grainSize = std::max<size_t>(grainSize, 1);
+    const size_t threadCount = queues.size();
+    if (threadCount == 1 || count <= grainSize) {
+        function(0, count, 0);
+        return;
+    }
+
+    // 按块连续地分给各线程 (相邻的块留在同一线程，缓存更友好)，多出来的工作靠窃取平衡
+    const size_t chunkCount = (count + grainSize - 1) / grainSize;
+    current = &function;
+    pending.store(chunkCount, std::memory_order_release);
+    for (size_t q = 0; q < threadCount; ++q) {
+        size_t firstChunk = chunkCount * q / threadCount, lastChunk = chunkCount * (q + 1) / threadCount;
+        if (firstChunk == lastChunk) continue;
+        std::lock_guard<std::mutex> lock(queues[q]->mutex);
+        // 自己从队尾取，因此倒序放入，让本线程按下标递增的顺序执行
+        for (size_t c = lastChunk; c-- > firstChunk;) {
+            queues[q]->jobs.push_back({ c * grainSize, std::min(count, (c + 1) * grainSize) });
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        ++batch;
+    }
+    wake.notify_all();
+
+    // 调用线程也参与执行，直到所有块都完成
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!RunOne(0)) std::this_thread::yield();
+    }
+    current = nullptr;
+}
+
+void JobSystem::WorkerLoop(int index) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait(lock, [&]() { return stopping || batch != seen; });
+            if (stopping) return;
+            seen = batch;
+        }
+        while (pending.load(std::memory_order_acquire) > 0) {
+            if (!RunOne(index)) std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::RunOne(int index) {
+    const int threadCount = static_cast<int>(queues.size());
+    Job job;
+    bool found = false;
+    {
+        WorkQueue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            found = true;
+        }
+    }
+    for (int k = 1; !found && k < threadCount; ++k) {
+        WorkQueue& victim = *queues[(index + k) % threadCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            found = true;
+            steals.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (!found) return false;
+
+    (*current)(job.begin, job.end, index);
+    pending.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+// 小型工作窃取 (work-stealing) 任务系统
+// 每个线程 (0 号为调用 ParallelFor 的线程，其余为常驻工作线程) 各有一个任务队列:
+// 自己从队尾取任务，队列空了就从其他线程的队头 "偷"，负载不均时空闲线程会自动分担。
+// ParallelFor 把 [0, count) 切成若干块分到各队列，调用线程也参与执行，全部完成后才返回。
+// 同一时刻只能有一个 ParallelFor 在执行 (只应由主线程调用)。
+class JobSystem {
+public:
+    // begin/end 为本块的下标范围，threadIndex 为执行线程的编号 (0 .. ThreadCount()-1，可用于选择线程私有缓冲区)
+    using RangeFunction = std::function<void(size_t begin, size_t end, int threadIndex)>;
+
+    // threadCount 为总线程数 (含调用线程)，<= 0 时使用全部硬件线程
+    explicit JobSystem(int threadCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    int ThreadCount() const { return static_cast<int>(queues.size()); }
+
+    // 并行执行 function，每块至多 grainSize 个元素；count <= grainSize 或只有一个线程时直接在调用线程上执行
+    void ParallelFor(size_t count, size_t grainSize, const RangeFunction& function);
+
+    // 累计被其他线程偷走执行的任务块数
+    size_t StealCount() const { return steals.load(std::memory_order_relaxed); }
+
+private:
+    struct Job {
+        size_t begin, end;
+    };
+
+    // 每个线程的任务队列 (独占缓存行，避免相邻队列的锁互相干扰)
+    struct alignas(64) WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    uint64_t batch = 0;    // 每次 ParallelFor 加一，唤醒工作线程
+    bool stopping = false;
+
+    const RangeFunction* current = nullptr; // 当前批次的任务函数
+    std::atomic<size_t> pending{ 0 };       // 当前批次尚未完成的块数
+    std::atomic<size_t> steals{ 0 };
+
+    void WorkerLoop(int index);
+
+    // 取一个任务块并执行 (先取自己的队列，再从其他队列窃取)；没有任务时返回 false
+    bool RunOne(int index);
+};
@@ -0,0 +1,72 @@
+#pragma once
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <vector>
+#include <random>
+#include <memory>
+#include <future>
+#include <chrono>
+#include "MazeGenerator.h"
+#include "Monster.h"
+#include "Collectible.h"
+
+// 一关的全部初始数据: 迷宫、怪物出生点、收集品位置
+struct Level {
+    MazeGenerator mazeGen;
+    std::vector<Monster> monsters;
+    std::vector<Collectible> collectibles;
+
+    Level(int w, int h, unsigned int seed) : mazeGen(w, h, seed) {}
+};
+
+// 生成一关 (只使用 seed 派生的随机数，不访问全局状态，可以在工作线程中调用)
+inline std::unique_ptr<Level> BuildLevel(int mazeWidth, int mazeHeight, float cellSize, unsigned int seed) {
+    auto level = std::make_unique<Level>(mazeWidth, mazeHeight, seed);
+    level->mazeGen.Generate();
+    level->mazeGen.BuildTree(); // 追逐用的生成树索引也在工作线程上建立
+    level->mazeGen.BuildPvs();  // 感知用的潜在可见集同上
+
+    // 怪物出生单元格
+    static const int MONSTER_SPAWNS[][2] = { { 5, 5 }, { 10, 10 }, { 15, 15 }, { 20, 15 }, { 18, 18 } };
+    for (const auto& cell : MONSTER_SPAWNS) {
+        level->monsters.emplace_back(cell[0] * cellSize + cellSize / 2, cell[1] * cellSize + cellSize / 2);
+    }
+
+    // 收集品随机放置 (迷宫用掉 seed 本身，这里用派生的种子)
+    std::mt19937 rng(seed ^ 0x9E3779B9u);
+    for (int i = 0; i < 5; ++i) {
+        int x = static_cast<int>(rng() % mazeWidth);
+        int y = static_cast<int>(rng() % mazeHeight);
+        level->collectibles.emplace_back(x * cellSize + cellSize / 2, y * cellSize + cellSize / 2);
+    }
+    return level;
+}
+
+// 后台生成下一关
+// Start 在工作线程上调用 BuildLevel，主线程每帧用 IsReady 查询，完成后 Take 取走结果直接交换进游戏。
+class LevelBuilder {
+public:
+    ~LevelBuilder() {
+        if (pending.valid()) pending.wait();
+    }
+
+    // 开始生成 (已有任务在进行时忽略)
+    void Start(int mazeWidth, int mazeHeight, float cellSize, unsigned int seed) {
+        if (pending.valid()) return;
+        pending = std::async(std::launch::async, BuildLevel, mazeWidth, mazeHeight, cellSize, seed);
+    }
+
+    bool IsBuilding() const { return pending.valid(); }
+
+    bool IsReady() const {
+        return pending.valid() && pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    // 取走生成结果 (尚未完成时阻塞等待)
+    std::unique_ptr<Level> Take() {
+        return pending.get();
+    }
+
+private:
+    std::future<std::unique_ptr<Level>> pending;
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include "MazeGrid.h"
+
+// 精确的网格视线检测 (Amanatides-Woo 体素遍历)
+// 从起点所在格出发，按线段参数 t 依次跨过经过的每一条格子边界，每条边界只检查一次对应的墙。
+// tMax/tDelta 在循环前算好，循环内只有加法和比较，没有除法。
+// 墙视为闭线段: 线段恰好穿过格点 (四个格子的公共角) 时，只要该格点相连的任意一堵墙存在即视为被挡住。
+// 起点或终点在迷宫外时视为不可见。坐标为世界坐标 (格子 (x, y) 覆盖 [x, x+1) * cellSize)。
+inline bool HasLineOfSight(const MazeGrid& grid, float cellSize, float startX, float startY, float endX, float endY) {
+    int x = static_cast<int>(std::floor(startX / cellSize));
+    int y = static_cast<int>(std::floor(startY / cellSize));
+    const int lastX = static_cast<int>(std::floor(endX / cellSize));
+    const int lastY = static_cast<int>(std::floor(endY / cellSize));
+    if (x < 0 || x >= grid.width || y < 0 || y >= grid.height) return false;
+    if (lastX < 0 || lastX >= grid.width || lastY < 0 || lastY >= grid.height) return false;
+
+    const double dx = static_cast<double>(endX) - startX;
+    const double dy = static_cast<double>(endY) - startY;
+    const int stepX = lastX > x ? 1 : (lastX < x ? -1 : 0);
+    const int stepY = lastY > y ? 1 : (lastY < y ? -1 : 0);
+    const double infinity = std::numeric_limits<double>::infinity();
+    // 到达下一条竖直/水平边界时的 t，以及每跨过一格 t 的增量
+    double tMaxX = stepX > 0 ? ((x + 1) * static_cast<double>(cellSize) - startX) / dx
+                 : stepX < 0 ? (x * static_cast<double>(cellSize) - startX) / dx : infinity;
+    double tMaxY = stepY > 0 ? ((y + 1) * static_cast<double>(cellSize) - startY) / dy
+                 : stepY < 0 ? (y * static_cast<double>(cellSize) - startY) / dy : infinity;
+    const double tDeltaX = stepX != 0 ? cellSize / std::abs(dx) : infinity;
+    const double tDeltaY = stepY != 0 ? cellSize / std::abs(dy) : infinity;
+    const int wallX = stepX > 0 ? WALL_RIGHT : WALL_LEFT;
+    const int wallY = stepY > 0 ? WALL_BOTTOM : WALL_TOP;
+
+    while (x != lastX || y != lastY) {
+        // 某一轴已到终点格时只沿另一轴前进 (防止舍入误差越过终点)
+        bool crossX = y == lastY || (x != lastX && tMaxX < tMaxY);
+        bool crossY = x == lastX || (y != lastY && tMaxY < tMaxX);
+        if (!crossX && !crossY) {
+            // 恰好穿过格点 (vx, vy): 检查与它相连的四堵墙
+            int vx = x + (stepX > 0), vy = y + (stepY > 0);
+            if (vx <= 0 || vx >= grid.width || vy <= 0 || vy >= grid.height) return false;
+            if (grid.HasWall(vx - 1, vy - 1, WALL_RIGHT) || grid.HasWall(vx - 1, vy, WALL_RIGHT)
+                || grid.HasWall(vx - 1, vy - 1, WALL_BOTTOM) || grid.HasWall(vx, vy - 1, WALL_BOTTOM)) return false;
+            x += stepX;
+            y += stepY;
+            tMaxX += tDeltaX;
+            tMaxY += tDeltaY;
+        }
+        else if (crossX) {
+            if (grid.HasWall(x, y, wallX)) return false;
+            x += stepX;
+            tMaxX += tDeltaX;
+        }
+        else {
+            if (grid.HasWall(x, y, wallY)) return false;
+            y += stepY;
+            tMaxY += tDeltaY;
+        }
+    }
+    return true;
+}
+
+// 批量视线检测: count 个起点 (xs[i], ys[i]) 到同一目标的视线，结果写入 visible[i] (1 = 可见)
+// 与目标同格的起点直接判为可见；返回可见的数量。结果与逐条调用 HasLineOfSight 完全相同。
+// 视线经过的格子两两相邻、之间没有墙、且坐标单调朝目标变化 (与 MazePvs 的保守集相同)，
+// 所以每批先从目标格向四个象限做一次单调可达的动态规划 (半径取起点到目标的最大切比雪夫距离，不超过 maxRange)，
+// 不可达的起点只需查一个字节就判为不可见，只有可达的起点 (以及半径外的起点) 才逐格遍历。
+// 动态规划的格子数远多于视线数时不值得做，直接逐条检测。
+inline size_t HasLineOfSightBatch(const MazeGrid& grid, float cellSize, const float* xs, const float* ys, size_t count,
+                                  float targetX, float targetY, uint8_t* visible, int maxRange = 64) {
+    const int targetCellX = static_cast<int>(std::floor(targetX / cellSize));
+    const int targetCellY = static_cast<int>(std::floor(targetY / cellSize));
+    if (targetCellX < 0 || targetCellX >= grid.width || targetCellY < 0 || targetCellY >= grid.height) {
+        for (size_t i = 0; i < count; ++i) visible[i] = 0;
+        return 0;
+    }
+
+    int range = 0;
+    for (size_t i = 0; i < count; ++i) {
+        int cellX = static_cast<int>(std::floor(xs[i] / cellSize)), cellY = static_cast<int>(std::floor(ys[i] / cellSize));
+        range = std::max(range, std::max(std::abs(cellX - targetCellX), std::abs(cellY - targetCellY)));
+    }
+    range = std::min(range, std::max(maxRange, 0));
+    const int side = range * 2 + 1;
+    if (static_cast<size_t>(side) * side > count * 4) range = -1; // 视线太少: 不建可达表
+
+    static thread_local std::vector<uint8_t> reach;
+    auto at = [&](int dx, int dy) { return static_cast<size_t>(dy + range) * side + (dx + range); };
+    if (range >= 0) {
+        reach.assign(static_cast<size_t>(side) * side, 0);
+        reach[at(0, 0)] = 1;
+        for (int sy = -1; sy <= 1; sy += 2) {
+            for (int sx = -1; sx <= 1; sx += 2) {
+                for (int j = 0; j <= range; ++j) {
+                    for (int i = 0; i <= range; ++i) {
+                        if (i == 0 && j == 0) continue;
+                        int dx = i * sx, dy = j * sy;
+                        int x = targetCellX + dx, y = targetCellY + dy;
+                        if (x < 0 || x >= grid.width || y < 0 || y >= grid.height) continue;
+                        if ((i > 0 && reach[at(dx - sx, dy)] && !grid.HasWall(x - sx, y, sx > 0 ? WALL_RIGHT : WALL_LEFT))
+                            || (j > 0 && reach[at(dx, dy - sy)] && !grid.HasWall(x, y - sy, sy > 0 ? WALL_BOTTOM : WALL_TOP))) {
+                            reach[at(dx, dy)] = 1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    size_t visibleCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        int dx = static_cast<int>(std::floor(xs[i] / cellSize)) - targetCellX;
+        int dy = static_cast<int>(std::floor(ys[i] / cellSize)) - targetCellY;
+        bool result;
+        if (dx == 0 && dy == 0) result = true;
+        else if (std::abs(dx) <= range && std::abs(dy) <= range && !reach[at(dx, dy)]) result = false;
+        else result = HasLineOfSight(grid, cellSize, xs[i], ys[i], targetX, targetY);
+        visible[i] = result ? 1 : 0;
+        visibleCount += result;
+    }
+    return visibleCount;
+}
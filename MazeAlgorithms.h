@@ -0,0 +1,279 @@
+#pragma once
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <stack>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "MazeGrid.h"
+#include "EllerGenerator.h"
+#include "DisjointSet.h"
+
+// 迷宫生成模式
+enum class GenerationMode {
+    Recursive, // 递归回溯 (每个单元格一层调用栈，只适合小迷宫)
+    Iterative, // 显式栈回溯 (不受调用栈深度限制，同一种子下结果与递归版相同)
+    Eller,     // Eller 逐行生成 (见 EllerGenerator，可脱离 MazeGenerator 流式使用)
+    Kruskal,   // 随机 Kruskal (并查集)
+    Prim,      // 随机 Prim
+    Wilson     // Wilson (擦除回路的随机游走，生成树服从均匀分布)
+};
+
+// 每格 1 位的标记位图
+class CellBitmap {
+public:
+    void Reset(size_t cellCount) { bits.assign((cellCount + 63) / 64, 0); }
+    void Release() { std::vector<uint64_t>().swap(bits); }
+    bool Test(size_t index) const { return (bits[index >> 6] >> (index & 63)) & 1u; }
+    void Set(size_t index) { bits[index >> 6] |= 1ull << (index & 63); }
+    size_t MemoryBytes() const { return bits.capacity() * sizeof(uint64_t); }
+
+private:
+    std::vector<uint64_t> bits;
+};
+
+// 迷宫生成算法接口
+// Carve 在墙壁全部封闭的 grid 上打通墙壁，得到一个完美迷宫 (任意两格之间恰有一条路径)。
+// 所有算法都只从传入的 rng 取随机数，同一种子得到同一迷宫。
+class MazeAlgorithm {
+public:
+    virtual ~MazeAlgorithm() = default;
+
+    virtual const char* Name() const = 0;
+    virtual void Carve(MazeGrid& grid, std::mt19937& rng) = 0;
+
+    // 上一次 Carve 的峰值工作内存 (字节，不含 grid 本身)
+    size_t PeakWorkingBytes() const { return peakBytes; }
+
+protected:
+    // 方向偏移 (下标即墙的编号: 上右下左)
+    static constexpr int DX[4] = { 0, 1, 0, -1 };
+    static constexpr int DY[4] = { -1, 0, 1, 0 };
+
+    size_t peakBytes = 0;
+
+    void TrackPeak(size_t bytes) { peakBytes = std::max(peakBytes, bytes); }
+
+    static bool InBounds(const MazeGrid& grid, int x, int y) {
+        return x >= 0 && x < grid.width && y >= 0 && y < grid.height;
+    }
+};
+
+// 显式栈回溯 (从 (0, 0) 出发的深度优先搜索)
+class BacktrackerAlgorithm : public MazeAlgorithm {
+public:
+    const char* Name() const override { return "Backtracker"; }
+
+    void Carve(MazeGrid& grid, std::mt19937& rng) override {
+        peakBytes = 0;
+        const int width = grid.width;
+        CellBitmap visited;
+        visited.Reset(static_cast<size_t>(width) * grid.height);
+        std::stack<BacktrackFrame, std::vector<BacktrackFrame>> frames;
+
+        auto enter = [&](int x, int y) {
+            int order[4] = { 0, 1, 2, 3 };
+            visited.Set(static_cast<size_t>(y) * width + x);
+            std::shuffle(order, order + 4, rng);
+            uint8_t packed = static_cast<uint8_t>(order[0] | (order[1] << 2) | (order[2] << 4) | (order[3] << 6));
+            frames.push({ static_cast<uint32_t>(y * width + x), packed, 0 });
+        };
+
+        size_t maxDepth = 0;
+        enter(0, 0);
+        while (!frames.empty()) {
+            BacktrackFrame& frame = frames.top();
+            if (frame.next == 4) { // 四个方向都已尝试，回溯
+                frames.pop();
+                continue;
+            }
+            int dir = (frame.order >> (frame.next * 2)) & 3;
+            ++frame.next;
+
+            int x = static_cast<int>(frame.cell % width);
+            int y = static_cast<int>(frame.cell / width);
+            int nx = x + DX[dir];
+            int ny = y + DY[dir];
+
+            if (InBounds(grid, nx, ny) && !visited.Test(static_cast<size_t>(ny) * width + nx)) {
+                grid.RemoveWall(x, y, dir);
+                enter(nx, ny);
+                maxDepth = std::max(maxDepth, frames.size());
+            }
+        }
+        TrackPeak(visited.MemoryBytes() + maxDepth * sizeof(BacktrackFrame));
+    }
+
+private:
+    // 栈帧: 单元格索引 + 打乱后的方向顺序 (每个方向 2 位) + 下一个要尝试的序号
+    struct BacktrackFrame {
+        uint32_t cell;
+        uint8_t order;
+        uint8_t next;
+    };
+};
+
+// 随机 Kruskal: 所有内部墙随机排序，墙两侧不连通时打通
+class KruskalAlgorithm : public MazeAlgorithm {
+public:
+    const char* Name() const override { return "Kruskal"; }
+
+    void Carve(MazeGrid& grid, std::mt19937& rng) override {
+        peakBytes = 0;
+        const int width = grid.width, height = grid.height;
+        // 墙编号: 单元格索引 * 2 + (0 = 右墙, 1 = 下墙)
+        std::vector<uint32_t> walls;
+        walls.reserve(static_cast<size_t>(width) * height * 2);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                uint32_t cell = static_cast<uint32_t>(y * width + x);
+                if (x + 1 < width) walls.push_back(cell * 2);
+                if (y + 1 < height) walls.push_back(cell * 2 + 1);
+            }
+        }
+        std::shuffle(walls.begin(), walls.end(), rng);
+
+        DisjointSet sets(static_cast<size_t>(width) * height);
+        TrackPeak(walls.capacity() * sizeof(uint32_t) + sets.MemoryBytes());
+
+        size_t remaining = static_cast<size_t>(width) * height - 1; // 生成树的边数
+        for (uint32_t wall : walls) {
+            if (remaining == 0) break;
+            uint32_t cell = wall / 2;
+            bool bottom = wall & 1u;
+            uint32_t other = bottom ? cell + width : cell + 1;
+            if (sets.Union(cell, other)) {
+                grid.RemoveWall(cell % width, cell / width, bottom ? WALL_BOTTOM : WALL_RIGHT);
+                --remaining;
+            }
+        }
+    }
+};
+
+// 随机 Prim: 维护与已生成区域相邻的边界格，每次随机取一个接入迷宫
+class PrimAlgorithm : public MazeAlgorithm {
+public:
+    const char* Name() const override { return "Prim"; }
+
+    void Carve(MazeGrid& grid, std::mt19937& rng) override {
+        peakBytes = 0;
+        const int width = grid.width, height = grid.height;
+        const size_t cellCount = static_cast<size_t>(width) * height;
+        CellBitmap inMaze, inFrontier;
+        inMaze.Reset(cellCount);
+        inFrontier.Reset(cellCount);
+        std::vector<uint32_t> frontier;
+        size_t frontierPeak = 0;
+
+        auto addCell = [&](uint32_t cell) {
+            inMaze.Set(cell);
+            int x = cell % width, y = cell / width;
+            for (int dir = 0; dir < 4; ++dir) {
+                int nx = x + DX[dir], ny = y + DY[dir];
+                if (!InBounds(grid, nx, ny)) continue;
+                uint32_t next = static_cast<uint32_t>(ny * width + nx);
+                if (!inMaze.Test(next) && !inFrontier.Test(next)) {
+                    inFrontier.Set(next);
+                    frontier.push_back(next);
+                }
+            }
+        };
+
+        addCell(static_cast<uint32_t>(rng() % cellCount));
+        while (!frontier.empty()) {
+            size_t pick = rng() % frontier.size();
+            uint32_t cell = frontier[pick];
+            frontier[pick] = frontier.back();
+            frontier.pop_back();
+
+            // 随机选一个已在迷宫中的邻居打通
+            int x = cell % width, y = cell / width;
+            int candidates[4], count = 0;
+            for (int dir = 0; dir < 4; ++dir) {
+                int nx = x + DX[dir], ny = y + DY[dir];
+                if (InBounds(grid, nx, ny) && inMaze.Test(static_cast<size_t>(ny) * width + nx)) candidates[count++] = dir;
+            }
+            grid.RemoveWall(x, y, candidates[rng() % count]);
+            addCell(cell);
+            frontierPeak = std::max(frontierPeak, frontier.capacity());
+        }
+        TrackPeak(frontierPeak * sizeof(uint32_t) + inMaze.MemoryBytes() + inFrontier.MemoryBytes());
+    }
+};
+
+// Wilson: 从未加入的格子出发随机游走，直到碰到已生成的树，再把擦除回路后的路径加入树。
+// 每格记录最后一次离开时的方向，沿该方向回放即得到擦除回路的路径。
+class WilsonAlgorithm : public MazeAlgorithm {
+public:
+    const char* Name() const override { return "Wilson"; }
+
+    void Carve(MazeGrid& grid, std::mt19937& rng) override {
+        const int width = grid.width, height = grid.height;
+        const size_t cellCount = static_cast<size_t>(width) * height;
+        CellBitmap inTree;
+        inTree.Reset(cellCount);
+        std::vector<uint8_t> exitDir(cellCount, 0);
+        peakBytes = inTree.MemoryBytes() + exitDir.capacity();
+
+        inTree.Set(rng() % cellCount);
+        for (size_t start = 0; start < cellCount; ++start) {
+            if (inTree.Test(start)) continue;
+
+            // 随机游走直到碰到树
+            int x = static_cast<int>(start % width), y = static_cast<int>(start / width);
+            while (!inTree.Test(static_cast<size_t>(y) * width + x)) {
+                int dir;
+                do {
+                    dir = static_cast<int>(rng() & 3u);
+                } while (!InBounds(grid, x + DX[dir], y + DY[dir]));
+                exitDir[static_cast<size_t>(y) * width + x] = static_cast<uint8_t>(dir);
+                x += DX[dir];
+                y += DY[dir];
+            }
+
+            // 沿记录的方向回放路径并加入树
+            x = static_cast<int>(start % width);
+            y = static_cast<int>(start / width);
+            while (!inTree.Test(static_cast<size_t>(y) * width + x)) {
+                size_t cell = static_cast<size_t>(y) * width + x;
+                int dir = exitDir[cell];
+                inTree.Set(cell);
+                grid.RemoveWall(x, y, dir);
+                x += DX[dir];
+                y += DY[dir];
+            }
+        }
+    }
+};
+
+// Eller: 逐行生成 (工作内存 O(width))
+class EllerAlgorithm : public MazeAlgorithm {
+public:
+    const char* Name() const override { return "Eller"; }
+
+    void Carve(MazeGrid& grid, std::mt19937& rng) override {
+        const int width = grid.width;
+        EllerGenerator eller(width, rng());
+        // 当前行 + 集合编号/并查集/计数等每列若干个 int
+        peakBytes = static_cast<size_t>(width) * (sizeof(uint8_t) * 3 + sizeof(int) * 4);
+        eller.Run(grid.height, [&](const MazeRow& row) {
+            for (int x = 0; x < width; ++x) {
+                if (!row.HasRightWall(x)) grid.RemoveWall(x, row.y, WALL_RIGHT);
+                if (!row.HasBottomWall(x)) grid.RemoveWall(x, row.y, WALL_BOTTOM);
+            }
+            return true;
+        });
+    }
+};
+
+// 根据生成模式创建算法 (Recursive 由 MazeGenerator 自己处理，这里返回显式栈版本)
+inline std::unique_ptr<MazeAlgorithm> CreateMazeAlgorithm(GenerationMode mode) {
+    switch (mode) {
+    case GenerationMode::Eller:   return std::make_unique<EllerAlgorithm>();
+    case GenerationMode::Kruskal: return std::make_unique<KruskalAlgorithm>();
+    case GenerationMode::Prim:    return std::make_unique<PrimAlgorithm>();
+    case GenerationMode::Wilson:  return std::make_unique<WilsonAlgorithm>();
+    default:                      return std::make_unique<BacktrackerAlgorithm>();
+    }
+}
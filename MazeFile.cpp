@@ -0,0 +1,131 @@
+#include "MazeFile.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAZE_FILE_MAGIC[4] = { 'D', 'D', 'M', 'Z' };
+
+// 只读的文件映射，析构时解除映射
+class MappedFile {
+public:
+    ~MappedFile() {
+#ifdef _WIN32
+        if (view) UnmapViewOfFile(view);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (view) munmap(const_cast<void*>(view), size);
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    bool Open(const std::string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return false;
+        size = static_cast<size_t>(fileSize.QuadPart);
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return false;
+        view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+        fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) return false;
+        size = static_cast<size_t>(st.st_size);
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) return false;
+        view = p;
+#endif
+        return view != nullptr;
+    }
+
+    const uint8_t* Data() const { return static_cast<const uint8_t*>(view); }
+    size_t Size() const { return size; }
+
+private:
+    const void* view = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+} // namespace
+
+bool SaveMazeFile(const std::string& path, const MazeGrid& grid, unsigned int seed) {
+    MazeFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAZE_FILE_MAGIC, sizeof(header.magic));
+    header.version = MAZE_FILE_VERSION;
+    header.width = static_cast<uint32_t>(grid.width);
+    header.height = static_cast<uint32_t>(grid.height);
+    header.seed = seed;
+    header.wordsPerRow = static_cast<uint32_t>(grid.WordsPerRow());
+    header.dataOffset = MAZE_FILE_HEADER_SIZE;
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "ERROR::MAZE_FILE::CANNOT_OPEN_FOR_WRITE " << path << std::endl;
+        return false;
+    }
+    // 各行在内存中是连续的，一次写出全部墙壁数据
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    size_t wordCount = static_cast<size_t>(grid.WordsPerRow()) * grid.height;
+    if (ok && wordCount > 0) ok = std::fwrite(grid.RowWords(0), sizeof(uint64_t), wordCount, file) == wordCount;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) std::cerr << "ERROR::MAZE_FILE::WRITE_FAILED " << path << std::endl;
+    return ok;
+}
+
+bool LoadMazeFile(const std::string& path, MazeGrid& grid, unsigned int& seed) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->Open(path)) {
+        std::cerr << "ERROR::MAZE_FILE::CANNOT_MAP " << path << std::endl;
+        return false;
+    }
+
+    MazeFileHeader header;
+    if (file->Size() < sizeof(header)) {
+        std::cerr << "ERROR::MAZE_FILE::TRUNCATED_HEADER " << path << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file->Data(), sizeof(header));
+    if (std::memcmp(header.magic, MAZE_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != MAZE_FILE_VERSION) {
+        std::cerr << "ERROR::MAZE_FILE::BAD_MAGIC_OR_VERSION " << path << std::endl;
+        return false;
+    }
+
+    uint64_t expectedWordsPerRow = (static_cast<uint64_t>(header.width) + MazeGrid::CELLS_PER_WORD - 1) / MazeGrid::CELLS_PER_WORD;
+    uint64_t dataBytes = expectedWordsPerRow * header.height * sizeof(uint64_t);
+    if (header.width == 0 || header.height == 0 || header.width > INT32_MAX || header.height > INT32_MAX
+        || header.wordsPerRow != expectedWordsPerRow || header.dataOffset % sizeof(uint64_t) != 0
+        || header.dataOffset > file->Size() || file->Size() - header.dataOffset < dataBytes) {
+        std::cerr << "ERROR::MAZE_FILE::BAD_DIMENSIONS " << path << std::endl;
+        return false;
+    }
+
+    const uint64_t* data = reinterpret_cast<const uint64_t*>(file->Data() + header.dataOffset);
+    grid.AttachExternal(static_cast<int>(header.width), static_cast<int>(header.height), data, file);
+    seed = header.seed;
+    return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "MazeGrid.h"
+
+// 迷宫二进制文件格式 (小端序)
+//   偏移  大小  内容
+//   0     4     魔数 "DDMZ"
+//   4     4     版本号 (MAZE_FILE_VERSION)
+//   8     4     宽度
+//   12    4     高度
+//   16    4     生成种子
+//   20    4     每行的 64 位字数 (与 MazeGrid::WordsPerRow 相同)
+//   24    8     墙壁数据的起始偏移 (MAZE_FILE_HEADER_SIZE)
+//   32    32    保留 (填 0)
+//   64    ...   墙壁数据: height 行，每行 wordsPerRow 个 uint64，布局与 MazeGrid 内存中完全相同
+// 数据按 64 字节对齐，加载时直接内存映射文件，不做解析和拷贝 (目标平台均为小端序)。
+const uint32_t MAZE_FILE_VERSION = 1;
+const uint32_t MAZE_FILE_HEADER_SIZE = 64;
+
+struct MazeFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t seed;
+    uint32_t wordsPerRow;
+    uint64_t dataOffset;
+    uint8_t reserved[32];
+};
+static_assert(sizeof(MazeFileHeader) == MAZE_FILE_HEADER_SIZE, "MazeFileHeader must be 64 bytes");
+
+// 保存迷宫 (失败时输出错误并返回 false)
+bool SaveMazeFile(const std::string& path, const MazeGrid& grid, unsigned int seed);
+
+// 内存映射加载迷宫: grid 直接引用映射的文件内容 (第一次修改时才复制)，
+// 映射在 grid 及其所有副本都释放后关闭。只校验文件头，失败时输出错误并返回 false，grid 不变。
+bool LoadMazeFile(const std::string& path, MazeGrid& grid, unsigned int& seed);
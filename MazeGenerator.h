@@ -3,57 +3,198 @@
 #include <vector>
 #include <random>
 #include <algorithm>
-#include <stack>
-
-// 迷宫单元格结构体
-struct Cell {
-    bool visited = false;
-    bool walls[4] = { true, true, true, true }; // 上右下左
-};
+#include <cstdint>
+#include <thread>
+#include <atomic>
+#include <string>
+#include "MazeGrid.h"
+#include "MazeAlgorithms.h"
+#include "DisjointSet.h"
+#include "MazeFile.h"
+#include "MazeTree.h"
+#include "MazePvs.h"
+#include "MazeHierarchy.h"
+#include "CorridorGraph.h"
 
 // 迷宫生成类
 class MazeGenerator {
 public:
     int width, height;
-    std::vector<std::vector<Cell>> maze;
+    MazeGrid maze; // 墙壁数据 (每格 2 位)
     std::mt19937 rng;
+    unsigned int seed; // 当前随机种子，相同种子生成相同迷宫
+    MazeTree tree;     // 生成树索引 (可选，由 BuildTree 建立，迷宫改变后自动清空)
+    MazePvs pvs;       // 潜在可见集 (可选，由 BuildPvs 建立，迷宫改变后自动清空)
+    MazeHierarchy hierarchy; // 分层寻路的抽象图 (可选，由 BuildHierarchy 建立，迷宫改变后自动清空)
+    CorridorGraph corridors; // 走廊图 (可选，由 BuildCorridors 建立，迷宫改变后自动清空)
+    uint32_t epoch;          // 迷宫纪元: 每次生成或加载都换成一个全局唯一的新值，缓存 (如 PathCache) 据此判断是否过期
+
+    MazeGenerator(int w, int h) : MazeGenerator(w, h, std::random_device{}()) {}
+
+    MazeGenerator(int w, int h, unsigned int s) : width(w), height(h), maze(w, h), rng(s), seed(s), epoch(NextEpoch()) {}
 
-    MazeGenerator(int w, int h) : width(w), height(h), rng(std::random_device{}()) {
-        maze.resize(height, std::vector<Cell>(width));
+    // 重新设置随机种子
+    void Seed(unsigned int s) {
+        seed = s;
+        rng.seed(s);
     }
 
-    void Generate() {
+    void Generate(GenerationMode mode = GenerationMode::Iterative) {
         // 重置迷宫
-        for (auto& row : maze) {
-            for (auto& cell : row) {
-                cell.visited = false;
-                for (int i = 0; i < 4; ++i) cell.walls[i] = true;
+        maze.CloseAll();
+        InvalidateDerived();
+        if (mode == GenerationMode::Recursive) {
+            visited.Reset(static_cast<size_t>(width) * height);
+            generateRecursiveBacktracker(0, 0);
+            // 访问标记只在生成时需要，生成完即释放
+            visited.Release();
+        }
+        else {
+            CreateMazeAlgorithm(mode)->Carve(maze, rng);
+        }
+    }
+
+    // 使用外部提供的算法生成
+    void Generate(MazeAlgorithm& algorithm) {
+        maze.CloseAll();
+        InvalidateDerived();
+        algorithm.Carve(maze, rng);
+    }
+
+    // 建立生成树索引 (距离/下一步查询，见 MazeTree)
+    void BuildTree() {
+        tree.Build(maze);
+    }
+
+    // 建立潜在可见集 (格子之间的可见性查询，见 MazePvs)
+    void BuildPvs(const PvsSettings& settings = PvsSettings()) {
+        pvs.Build(maze, settings);
+    }
+
+    // 建立分层寻路的抽象图 (大迷宫上的 HPA*，见 MazeHierarchy)
+    void BuildHierarchy(int clusterSize = 16) {
+        hierarchy.Build(maze, clusterSize);
+    }
+
+    // 建立走廊图 (只含岔路口与死胡同的压缩图，见 CorridorGraph)
+    void BuildCorridors() {
+        corridors.Build(maze);
+    }
+
+    // 保存当前迷宫和种子 (格式见 MazeFile.h)
+    bool Save(const std::string& path) const {
+        return SaveMazeFile(path, maze, seed);
+    }
+
+    // 加载迷宫文件 (内存映射，不重新生成)，尺寸和种子随文件更新
+    bool Load(const std::string& path) {
+        unsigned int fileSeed = 0;
+        if (!LoadMazeFile(path, maze, fileSeed)) return false;
+        InvalidateDerived();
+        width = maze.width;
+        height = maze.height;
+        Seed(fileSeed);
+        return true;
+    }
+
+    // 分块并行生成
+    // 网格被切成 tileSize x tileSize 的块 (tileSize 向上取整到 32 的倍数，使每块独占各行中的 64 位字，
+    // 工作线程可以直接写回 maze 而不互相干扰)。每块内部用显式栈回溯生成完美迷宫，
+    // 然后用并查集把各块连成一棵生成树: 相邻块对随机排序，每合并一对就在它们的边界上开一扇门。
+    // 各块的种子预先从 rng 中取出，结果与线程数无关。threadCount <= 0 时使用全部硬件线程。
+    void GenerateParallel(int threadCount = 0, int tileSize = 256) {
+        if (threadCount <= 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+        tileSize = std::max(1, (tileSize + MazeGrid::CELLS_PER_WORD - 1) / MazeGrid::CELLS_PER_WORD) * MazeGrid::CELLS_PER_WORD;
+        int tilesX = (width + tileSize - 1) / tileSize;
+        int tilesY = (height + tileSize - 1) / tileSize;
+        int tileCount = tilesX * tilesY;
+
+        std::vector<unsigned int> tileSeeds(tileCount);
+        for (auto& tileSeed : tileSeeds) tileSeed = rng();
+
+        maze.CloseAll();
+        InvalidateDerived();
+
+        // 1. 各块独立生成
+        std::atomic<int> nextTile(0);
+        auto worker = [&]() {
+            for (int t = nextTile++; t < tileCount; t = nextTile++) {
+                int x0 = (t % tilesX) * tileSize;
+                int y0 = (t / tilesX) * tileSize;
+                MazeGenerator tile(std::min(tileSize, width - x0), std::min(tileSize, height - y0), tileSeeds[t]);
+                tile.Generate(GenerationMode::Iterative);
+
+                int firstWord = x0 / MazeGrid::CELLS_PER_WORD;
+                for (int y = 0; y < tile.height; ++y) {
+                    std::copy_n(tile.maze.RowWords(y), tile.maze.WordsPerRow(), maze.RowWords(y0 + y) + firstWord);
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        for (int i = 1; i < threadCount && i < tileCount; ++i) threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads) thread.join();
+
+        // 2. 用并查集在块之间开门，把各块连成一棵生成树
+        struct TileEdge { int a, b; bool toRight; };
+        std::vector<TileEdge> edges;
+        for (int t = 0; t < tileCount; ++t) {
+            if (t % tilesX + 1 < tilesX) edges.push_back({ t, t + 1, true });
+            if (t / tilesX + 1 < tilesY) edges.push_back({ t, t + tilesX, false });
+        }
+        std::shuffle(edges.begin(), edges.end(), rng);
+
+        DisjointSet tiles(tileCount);
+        for (const auto& edge : edges) {
+            if (!tiles.Union(edge.a, edge.b)) continue;
+            int x0 = (edge.a % tilesX) * tileSize;
+            int y0 = (edge.a / tilesX) * tileSize;
+            if (edge.toRight) {
+                int y = y0 + static_cast<int>(rng() % std::min(tileSize, height - y0));
+                maze.RemoveWall(x0 + tileSize - 1, y, WALL_RIGHT);
+            }
+            else {
+                int x = x0 + static_cast<int>(rng() % std::min(tileSize, width - x0));
+                maze.RemoveWall(x, y0 + tileSize - 1, WALL_BOTTOM);
             }
         }
-        generateRecursiveBacktracker(0, 0);
     }
 
 private:
-	// 递归回溯算法生成迷宫
-    void generateRecursiveBacktracker(int x, int y) {
-        static std::vector<std::pair<int, int>> directions = { {0,-1}, {1,0}, {0,1}, {-1,0} };
-        maze[y][x].visited = true;
-        std::shuffle(directions.begin(), directions.end(), rng);
+    // 方向偏移 (下标即墙的编号: 上右下左)
+    static constexpr int DX[4] = { 0, 1, 0, -1 };
+    static constexpr int DY[4] = { -1, 0, 1, 0 };
 
-        for (const auto& dir : directions) {
-            int nx = x + dir.first;
-            int ny = y + dir.second;
+    CellBitmap visited; // 递归生成期间的访问位图 (每格 1 位)
+
+    // 迷宫改变: 清空所有由墙壁派生的索引，并换一个新的纪元 (新增派生索引时只需在这里清空)
+    void InvalidateDerived() {
+        tree.Clear();
+        pvs.Clear();
+        hierarchy.Clear();
+        corridors.Clear();
+        epoch = NextEpoch();
+    }
 
-            if (nx >= 0 && nx < width && ny >= 0 && ny < height && !maze[ny][nx].visited) {
-                int wall_to_remove_current = 0, wall_to_remove_next = 2;
-                if (dir.first == 1) { wall_to_remove_current = 1; wall_to_remove_next = 3; }
-                else if (dir.first == -1) { wall_to_remove_current = 3; wall_to_remove_next = 1; }
-                else if (dir.second == 1) { wall_to_remove_current = 2; wall_to_remove_next = 0; }
-                else if (dir.second == -1) { wall_to_remove_current = 0; wall_to_remove_next = 2; }
+    // 全局递增的纪元 (关卡在后台线程生成，需要原子操作)
+    static uint32_t NextEpoch() {
+        static std::atomic<uint32_t> counter(0);
+        return ++counter;
+    }
+
+	// 递归回溯算法生成迷宫
+	// 每一层使用自己打乱的方向顺序 (此前共用一个 static 数组，子调用重新打乱后父调用会跳过部分方向，导致有单元格未连通)
+    void generateRecursiveBacktracker(int x, int y) {
+        int order[4] = { 0, 1, 2, 3 };
+        visited.Set(static_cast<size_t>(y) * width + x);
+        std::shuffle(order, order + 4, rng);
 
-                maze[y][x].walls[wall_to_remove_current] = false;
-                maze[ny][nx].walls[wall_to_remove_next] = false;
+        for (int dir : order) {
+            int nx = x + DX[dir];
+            int ny = y + DY[dir];
 
+            if (nx >= 0 && nx < width && ny >= 0 && ny < height && !visited.Test(static_cast<size_t>(ny) * width + nx)) {
+                maze.RemoveWall(x, y, dir);
                 generateRecursiveBacktracker(nx, ny);
             }
         }
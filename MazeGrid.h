@@ -0,0 +1,140 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <memory>
+
+// 墙壁方向 (上右下左，与 Monster::Direction 的取值一致)
+enum WallSide { WALL_TOP = 0, WALL_RIGHT = 1, WALL_BOTTOM = 2, WALL_LEFT = 3 };
+
+// 紧凑的迷宫墙壁存储
+// 每个单元格只存 2 位: bit0 = 右墙, bit1 = 下墙。
+// 上墙/左墙由上方/左侧邻居的下墙/右墙给出，因此每堵内部墙只存一次；
+// 迷宫外边界永远是墙 (RemoveWall 不会打通外边界)。
+// 所有行连续存放在一个 vector 中，每行按 64 位字对齐 (每字 32 个单元格)，
+// 不同行不会共用同一个字，方便按行并行写入。
+// 墙壁数据也可以直接引用外部内存 (例如内存映射的迷宫文件，见 MazeFile.h)，
+// 此时只读访问不做任何拷贝，第一次修改时才复制到自有的 vector 中。
+class MazeGrid {
+public:
+    int width = 0, height = 0;
+
+    MazeGrid() = default;
+    MazeGrid(int w, int h) { Resize(w, h); }
+
+    MazeGrid(const MazeGrid& other) { *this = other; }
+    MazeGrid(MazeGrid&& other) noexcept { *this = std::move(other); }
+
+    MazeGrid& operator=(const MazeGrid& other) {
+        if (this == &other) return *this;
+        width = other.width;
+        height = other.height;
+        stride = other.stride;
+        words = other.words;
+        external = other.external;
+        bits = external ? other.bits : words.data();
+        return *this;
+    }
+
+    MazeGrid& operator=(MazeGrid&& other) noexcept {
+        if (this == &other) return *this;
+        width = other.width;
+        height = other.height;
+        stride = other.stride;
+        words = std::move(other.words);
+        external = std::move(other.external);
+        bits = external ? other.bits : words.data();
+        other.width = other.height = other.stride = 0;
+        other.bits = nullptr;
+        return *this;
+    }
+
+    // 调整尺寸并把所有墙设为封闭
+    void Resize(int w, int h) {
+        width = w;
+        height = h;
+        stride = (w + CELLS_PER_WORD - 1) / CELLS_PER_WORD;
+        external.reset();
+        words.assign(static_cast<size_t>(stride) * h, ~0ull);
+        bits = words.data();
+    }
+
+    // 所有墙设为封闭
+    void CloseAll() {
+        Resize(width, height);
+    }
+
+    // 引用外部的墙壁数据 (布局必须与本类相同: height 行，每行 WordsPerRow() 个字)
+    // owner 负责保持 data 有效，MazeGrid 的所有副本共享它
+    void AttachExternal(int w, int h, const uint64_t* data, std::shared_ptr<const void> owner) {
+        width = w;
+        height = h;
+        stride = (w + CELLS_PER_WORD - 1) / CELLS_PER_WORD;
+        std::vector<uint64_t>().swap(words);
+        external = std::move(owner);
+        bits = data;
+    }
+
+    // 是否正在引用外部数据
+    bool IsExternal() const { return external != nullptr; }
+
+    // (x, y) 的 side 方向是否有墙 (调用方负责保证 x, y 在迷宫内)
+    bool HasWall(int x, int y, int side) const {
+        switch (side) {
+        case WALL_TOP:    return y == 0 || Bit(x, y - 1, BOTTOM_BIT);
+        case WALL_RIGHT:  return Bit(x, y, RIGHT_BIT);
+        case WALL_BOTTOM: return Bit(x, y, BOTTOM_BIT);
+        case WALL_LEFT:   return x == 0 || Bit(x - 1, y, RIGHT_BIT);
+        }
+        return true;
+    }
+
+    // 打通 (x, y) 的 side 方向的墙 (外边界的墙不会被打通)
+    void RemoveWall(int x, int y, int side) {
+        if (external) Detach();
+        switch (side) {
+        case WALL_TOP:    if (y > 0) ClearBit(x, y - 1, BOTTOM_BIT); break;
+        case WALL_RIGHT:  if (x + 1 < width) ClearBit(x, y, RIGHT_BIT); break;
+        case WALL_BOTTOM: if (y + 1 < height) ClearBit(x, y, BOTTOM_BIT); break;
+        case WALL_LEFT:   if (x > 0) ClearBit(x - 1, y, RIGHT_BIT); break;
+        }
+    }
+
+    // 墙壁数据占用的字节数
+    size_t MemoryBytes() const { return static_cast<size_t>(stride) * height * sizeof(uint64_t); }
+
+    // --- 按字直接访问 (批量拷贝/序列化用) ---
+    static const int CELLS_PER_WORD = 32;
+    int WordsPerRow() const { return stride; }
+    uint64_t* RowWords(int y) {
+        if (external) Detach();
+        return words.data() + static_cast<size_t>(y) * stride;
+    }
+    const uint64_t* RowWords(int y) const { return bits + static_cast<size_t>(y) * stride; }
+
+private:
+    static const int RIGHT_BIT = 0;
+    static const int BOTTOM_BIT = 1;
+
+    int stride = 0;                      // 每行占用的 64 位字数
+    std::vector<uint64_t> words;         // 自有的墙壁位图
+    const uint64_t* bits = nullptr;      // 读取用的数据指针 (指向 words 或外部数据)
+    std::shared_ptr<const void> external; // 外部数据的所有者 (为空表示使用 words)
+
+    // 把外部数据复制到自有存储 (写时复制)
+    void Detach() {
+        words.assign(bits, bits + static_cast<size_t>(stride) * height);
+        bits = words.data();
+        external.reset();
+    }
+
+    bool Bit(int x, int y, int bit) const {
+        uint64_t word = bits[static_cast<size_t>(y) * stride + (x / CELLS_PER_WORD)];
+        return (word >> ((x % CELLS_PER_WORD) * 2 + bit)) & 1u;
+    }
+
+    void ClearBit(int x, int y, int bit) {
+        words[static_cast<size_t>(y) * stride + (x / CELLS_PER_WORD)] &= ~(1ull << ((x % CELLS_PER_WORD) * 2 + bit));
+    }
+};
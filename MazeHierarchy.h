@@ -0,0 +1,374 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <algorithm>
+#include "MazeGrid.h"
+
+// 分层寻路 (HPA*) 的抽象图
+// 迷宫被切成 clusterSize x clusterSize 的簇。相邻两簇边界上的每个开口 (两侧格子之间没有墙) 给出一对入口节点，
+// 两者之间是代价为 1 的簇间边；同一簇内的入口两两在簇内做 BFS，能互相到达的连一条簇内边 (代价为步数)。
+// 图只依赖墙壁，建立后只读，可以被多个线程上的 HierarchicalPathfinder 同时使用。
+// 格子编号为 y * width + x；迷宫改变后需要重新 Build。
+class MazeHierarchy {
+public:
+    struct Edge {
+        uint32_t to;   // 目标节点
+        uint32_t cost; // 步数
+    };
+
+    void Build(const MazeGrid& grid, int clusterSize = 16) {
+        Clear();
+        width = grid.width;
+        height = grid.height;
+        cluster = std::max(2, clusterSize);
+        clustersX = (width + cluster - 1) / cluster;
+        clustersY = (height + cluster - 1) / cluster;
+        clusterStart.assign(static_cast<size_t>(clustersX) * clustersY + 1, 0);
+        if (width <= 0 || height <= 0) return;
+
+        // 1. 找出簇边界上的所有开口，按 (簇, 格子) 排序后编号 (同一格可能同时是向右和向下的入口，只编一次)
+        std::vector<uint32_t> cells;
+        std::vector<std::pair<uint32_t, uint32_t>> crossings; // 开口两侧的格子
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                uint32_t cell = static_cast<uint32_t>(y * width + x);
+                if ((x + 1) % cluster == 0 && x + 1 < width && !grid.HasWall(x, y, WALL_RIGHT)) crossings.push_back({ cell, cell + 1 });
+                if ((y + 1) % cluster == 0 && y + 1 < height && !grid.HasWall(x, y, WALL_BOTTOM)) crossings.push_back({ cell, cell + static_cast<uint32_t>(width) });
+            }
+        }
+        for (const auto& crossing : crossings) {
+            cells.push_back(crossing.first);
+            cells.push_back(crossing.second);
+        }
+        std::sort(cells.begin(), cells.end(), [&](uint32_t a, uint32_t b) {
+            uint32_t ca = ClusterOf(static_cast<int>(a)), cb = ClusterOf(static_cast<int>(b));
+            return ca != cb ? ca < cb : a < b;
+        });
+        cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+        nodeCells = cells;
+        for (uint32_t cell : nodeCells) ++clusterStart[ClusterOf(static_cast<int>(cell)) + 1];
+        for (size_t c = 1; c < clusterStart.size(); ++c) clusterStart[c] += clusterStart[c - 1];
+        auto nodeOf = [&](uint32_t cell) {
+            uint32_t c = ClusterOf(static_cast<int>(cell));
+            return static_cast<uint32_t>(std::lower_bound(nodeCells.begin() + clusterStart[c], nodeCells.begin() + clusterStart[c + 1], cell) - nodeCells.begin());
+        };
+
+        // 2. 簇间边 + 簇内边 (每个入口在所属簇内做一次 BFS)
+        struct RawEdge { uint32_t from, to, cost; };
+        std::vector<RawEdge> raw;
+        for (const auto& crossing : crossings) {
+            uint32_t a = nodeOf(crossing.first), b = nodeOf(crossing.second);
+            raw.push_back({ a, b, 1 });
+            raw.push_back({ b, a, 1 });
+        }
+        ClusterSearch search;
+        for (uint32_t c = 0; c + 1 < clusterStart.size(); ++c) {
+            for (uint32_t a = clusterStart[c]; a < clusterStart[c + 1]; ++a) {
+                search.Run(*this, grid, static_cast<int>(nodeCells[a]));
+                for (uint32_t b = a + 1; b < clusterStart[c + 1]; ++b) {
+                    uint32_t distance = search.Distance(*this, static_cast<int>(nodeCells[b]));
+                    if (distance == UNREACHED) continue;
+                    raw.push_back({ a, b, distance });
+                    raw.push_back({ b, a, distance });
+                }
+            }
+        }
+
+        // 3. 按起点整理成 CSR 邻接表
+        edgeStart.assign(nodeCells.size() + 1, 0);
+        for (const RawEdge& edge : raw) ++edgeStart[edge.from + 1];
+        for (size_t n = 1; n < edgeStart.size(); ++n) edgeStart[n] += edgeStart[n - 1];
+        edges.resize(raw.size());
+        std::vector<uint32_t> fill(edgeStart.begin(), edgeStart.end() - 1);
+        for (const RawEdge& edge : raw) edges[fill[edge.from]++] = Edge{ edge.to, edge.cost };
+    }
+
+    // 释放抽象图
+    void Clear() {
+        std::vector<uint32_t>().swap(nodeCells);
+        std::vector<uint32_t>().swap(clusterStart);
+        std::vector<uint32_t>().swap(edgeStart);
+        std::vector<Edge>().swap(edges);
+        width = height = 0;
+    }
+
+    // 抽象图是否与给定尺寸的迷宫对应
+    bool IsBuilt(int w, int h) const {
+        return !clusterStart.empty() && w == width && h == height;
+    }
+
+    int ClusterSize() const { return cluster; }
+    uint32_t ClusterOf(int cell) const {
+        return static_cast<uint32_t>((cell / width) / cluster * clustersX + (cell % width) / cluster);
+    }
+
+    size_t NodeCount() const { return nodeCells.size(); }
+    size_t EdgeCount() const { return edges.size(); }
+    int NodeCell(uint32_t node) const { return static_cast<int>(nodeCells[node]); }
+
+    // 簇 c 的入口节点为 [ClusterBegin(c), ClusterEnd(c))
+    uint32_t ClusterBegin(uint32_t c) const { return clusterStart[c]; }
+    uint32_t ClusterEnd(uint32_t c) const { return clusterStart[c + 1]; }
+
+    const Edge* EdgesBegin(uint32_t node) const { return edges.data() + edgeStart[node]; }
+    const Edge* EdgesEnd(uint32_t node) const { return edges.data() + edgeStart[node + 1]; }
+
+    size_t MemoryBytes() const {
+        return (nodeCells.capacity() + clusterStart.capacity() + edgeStart.capacity()) * sizeof(uint32_t) + edges.capacity() * sizeof(Edge);
+    }
+
+    static constexpr uint32_t UNREACHED = 0xFFFFFFFFu;
+
+    // 限定在一个簇内的 BFS (建图、接入起终点、展开路径时共用)
+    // 局部数组只有 clusterSize^2 大小，靠 generation 区分不同次搜索，不需要清空
+    class ClusterSearch {
+    public:
+        // 从 start 出发在其所在簇内做 BFS；visited 为本次访问的格子数
+        void Run(const MazeHierarchy& hierarchy, const MazeGrid& grid, int start) {
+            const int size = hierarchy.cluster;
+            const size_t localCount = static_cast<size_t>(size) * size;
+            if (distance.size() < localCount) {
+                distance.assign(localCount, 0);
+                stamp.assign(localCount, 0);
+                parent.assign(localCount, 0);
+                queue.reserve(localCount);
+            }
+            if (++generation == 0) {
+                std::fill(stamp.begin(), stamp.end(), 0u);
+                generation = 1;
+            }
+            const int width = hierarchy.width;
+            originX = (start % width) / size * size;
+            originY = (start / width) / size * size;
+            endX = std::min(originX + size, hierarchy.width);
+            endY = std::min(originY + size, hierarchy.height);
+            clusterSize = size;
+
+            static const int DX[4] = { 0, 1, 0, -1 };
+            static const int DY[4] = { -1, 0, 1, 0 };
+            queue.clear();
+            uint32_t local = Local(start % width, start / width);
+            stamp[local] = generation;
+            distance[local] = 0;
+            parent[local] = local;
+            queue.push_back(local);
+            for (size_t head = 0; head < queue.size(); ++head) {
+                uint32_t current = queue[head];
+                int x = originX + static_cast<int>(current % size), y = originY + static_cast<int>(current / size);
+                for (int dir = 0; dir < 4; ++dir) {
+                    if (grid.HasWall(x, y, dir)) continue;
+                    int nx = x + DX[dir], ny = y + DY[dir];
+                    if (nx < originX || nx >= endX || ny < originY || ny >= endY) continue; // 不出簇
+                    uint32_t next = Local(nx, ny);
+                    if (stamp[next] == generation) continue;
+                    stamp[next] = generation;
+                    distance[next] = distance[current] + 1;
+                    parent[next] = current;
+                    queue.push_back(next);
+                }
+            }
+            visited = queue.size();
+        }
+
+        // cell (必须与起点同簇) 到起点的步数，不可达时为 UNREACHED
+        uint32_t Distance(const MazeHierarchy& hierarchy, int cell) const {
+            uint32_t local = Local(cell % hierarchy.width, cell / hierarchy.width);
+            return stamp[local] == generation ? distance[local] : UNREACHED;
+        }
+
+        // 把从 cell 回到起点的格子 (含 cell，不含起点) 按 cell 在前的顺序追加到 out
+        void TraceBack(const MazeHierarchy& hierarchy, int cell, std::vector<int>& out) const {
+            uint32_t local = Local(cell % hierarchy.width, cell / hierarchy.width);
+            while (parent[local] != local) {
+                out.push_back((originY + static_cast<int>(local / clusterSize)) * hierarchy.width + originX + static_cast<int>(local % clusterSize));
+                local = parent[local];
+            }
+        }
+
+        size_t Visited() const { return visited; }
+
+    private:
+        std::vector<uint32_t> distance, stamp, parent, queue;
+        uint32_t generation = 0;
+        int originX = 0, originY = 0, endX = 0, endY = 0, clusterSize = 1;
+        size_t visited = 0;
+
+        uint32_t Local(int x, int y) const {
+            return static_cast<uint32_t>((y - originY) * clusterSize + (x - originX));
+        }
+    };
+
+private:
+    int width = 0, height = 0;
+    int cluster = 16;
+    int clustersX = 0, clustersY = 0;
+    std::vector<uint32_t> nodeCells;    // 入口节点所在的格子，按簇连续存放
+    std::vector<uint32_t> clusterStart; // 每簇第一个入口节点的编号 (CSR)
+    std::vector<uint32_t> edgeStart;    // 每个节点第一条边的下标 (CSR)
+    std::vector<Edge> edges;
+};
+
+// 在 MazeHierarchy 上的分层 A*
+// FindPath 只在起点/终点所在的簇内各做一次 BFS，把它们接入抽象图，再在抽象图上做 A* (曼哈顿距离启发，结果最短)，
+// 输出途经的入口格子 (路点)；相邻两个路点要么同簇 (簇内路径由 RefineSegment 展开)，要么隔着边界相邻。
+// 调用方可以只展开即将进入的那一簇，其余的留到走到时再展开。
+// 与 MazePathfinder 一样，搜索状态在多次搜索之间复用；每个线程各用一个实例。
+class HierarchicalPathfinder {
+public:
+    // 成功时 waypoints 为 起点, 入口..., 终点 (格子编号，相邻路点不重复)
+    // maxExpanded > 0 时抽象图上最多展开这么多节点，超出时放弃并返回 false
+    bool FindPath(const MazeHierarchy& hierarchy, const MazeGrid& grid, int startX, int startY, int goalX, int goalY, std::vector<int>& waypoints,
+                  size_t maxExpanded = 0) {
+        waypoints.clear();
+        expanded = 0;
+        localVisited = 0;
+        const int width = grid.width;
+        if (!hierarchy.IsBuilt(grid.width, grid.height)) return false;
+        if (startX < 0 || startX >= width || startY < 0 || startY >= grid.height) return false;
+        if (goalX < 0 || goalX >= width || goalY < 0 || goalY >= grid.height) return false;
+        const int start = startY * width + startX, goal = goalY * width + goalX;
+        const uint32_t startCluster = hierarchy.ClusterOf(start), goalCluster = hierarchy.ClusterOf(goal);
+
+        // 同簇且簇内可达: 不需要抽象图
+        search.Run(hierarchy, grid, start);
+        localVisited += search.Visited();
+        if (startCluster == goalCluster && search.Distance(hierarchy, goal) != MazeHierarchy::UNREACHED) {
+            waypoints.push_back(start);
+            if (goal != start) waypoints.push_back(goal);
+            return true;
+        }
+
+        const uint32_t nodeCount = static_cast<uint32_t>(hierarchy.NodeCount());
+        Prepare(nodeCount);
+        const uint32_t GOAL = nodeCount; // 虚拟终点
+        heap.clear();
+        for (uint32_t n = hierarchy.ClusterBegin(startCluster); n < hierarchy.ClusterEnd(startCluster); ++n) {
+            uint32_t d = search.Distance(hierarchy, hierarchy.NodeCell(n));
+            if (d != MazeHierarchy::UNREACHED) Relax(hierarchy, n, d, START, goalX, goalY, width);
+        }
+
+        // 终点接入: 记下终点簇的入口到终点的距离
+        search.Run(hierarchy, grid, goal);
+        localVisited += search.Visited();
+        for (uint32_t n = hierarchy.ClusterBegin(goalCluster); n < hierarchy.ClusterEnd(goalCluster); ++n) {
+            uint32_t d = search.Distance(hierarchy, hierarchy.NodeCell(n));
+            if (d == MazeHierarchy::UNREACHED) continue;
+            Node& node = nodes[n];
+            if (node.goalGeneration != generation || d < node.toGoal) {
+                node.goalGeneration = generation;
+                node.toGoal = d;
+            }
+        }
+
+        uint32_t bestCost = MazeHierarchy::UNREACHED, bestParent = START;
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), Greater);
+            HeapEntry top = heap.back();
+            heap.pop_back();
+            if (top.node == GOAL) break;
+            Node& node = nodes[top.node];
+            if (top.g != node.g) continue; // 过期的堆项
+            ++expanded;
+            if (maxExpanded != 0 && expanded > maxExpanded) return false;
+            if (node.goalGeneration == generation && node.g + node.toGoal < bestCost) {
+                // 经由本节点到达终点: 以 f = 总代价把虚拟终点放入堆，出堆时即为最优
+                bestCost = node.g + node.toGoal;
+                bestParent = top.node;
+                heap.push_back({ bestCost, bestCost, GOAL });
+                std::push_heap(heap.begin(), heap.end(), Greater);
+            }
+            for (const MazeHierarchy::Edge* edge = hierarchy.EdgesBegin(top.node); edge != hierarchy.EdgesEnd(top.node); ++edge) {
+                Relax(hierarchy, edge->to, node.g + edge->cost, top.node, goalX, goalY, width);
+            }
+        }
+        if (bestParent == START) return false;
+
+        // 回溯: 终点, 入口..., 起点
+        waypoints.push_back(goal);
+        for (uint32_t n = bestParent; n != START; n = nodes[n].parent) {
+            int cell = hierarchy.NodeCell(n);
+            if (cell != waypoints.back()) waypoints.push_back(cell);
+        }
+        if (start != waypoints.back()) waypoints.push_back(start);
+        std::reverse(waypoints.begin(), waypoints.end());
+        return true;
+    }
+
+    // 展开路点 from -> to (两者同簇，或隔着簇边界相邻) 为格子序列，追加到 cells (不含 from，含 to)
+    bool RefineSegment(const MazeHierarchy& hierarchy, const MazeGrid& grid, int from, int to, std::vector<int>& cells) {
+        const int width = grid.width;
+        int dx = to % width - from % width, dy = to / width - from / width;
+        if (std::abs(dx) + std::abs(dy) == 1 && hierarchy.ClusterOf(from) != hierarchy.ClusterOf(to)) {
+            int side = dx == 1 ? WALL_RIGHT : dx == -1 ? WALL_LEFT : dy == 1 ? WALL_BOTTOM : WALL_TOP;
+            if (grid.HasWall(from % width, from / width, side)) return false;
+            cells.push_back(to);
+            return true;
+        }
+        if (hierarchy.ClusterOf(from) != hierarchy.ClusterOf(to)) return false;
+        if (from == to) return true;
+        // 从 to 出发做 BFS，再从 from 沿父指针走回 to，得到的就是 from -> to 的顺序
+        search.Run(hierarchy, grid, to);
+        localVisited += search.Visited();
+        if (search.Distance(hierarchy, from) == MazeHierarchy::UNREACHED) return false;
+        size_t first = cells.size();
+        search.TraceBack(hierarchy, from, cells);
+        // TraceBack 含 from 不含 to: 去掉 from，补上 to
+        cells.erase(cells.begin() + first);
+        cells.push_back(to);
+        return true;
+    }
+
+    // 上一次 FindPath 在抽象图上展开的节点数
+    size_t LastExpanded() const { return expanded; }
+    // 自上一次 FindPath 起，簇内 BFS 访问的格子数 (接入起终点 + 已展开的段)
+    size_t LocalVisited() const { return localVisited; }
+
+    size_t MemoryBytes() const { return nodes.capacity() * sizeof(Node) + heap.capacity() * sizeof(HeapEntry); }
+
+private:
+    static constexpr uint32_t START = 0xFFFFFFFFu; // 父节点为虚拟起点
+
+    struct Node {
+        uint32_t generation;     // 所属的搜索编号
+        uint32_t g;              // 起点到此的步数
+        uint32_t parent;         // 前一个入口节点 (START 表示直接连着起点)
+        uint32_t goalGeneration; // toGoal 有效的搜索编号
+        uint32_t toGoal;         // 到终点的簇内步数 (只对终点簇的入口有效)
+    };
+    struct HeapEntry {
+        uint32_t f, g, node;
+    };
+
+    MazeHierarchy::ClusterSearch search;
+    std::vector<Node> nodes;
+    std::vector<HeapEntry> heap; // 开放集 (惰性删除: 出堆时 g 与节点不符的项直接丢弃)
+    uint32_t generation = 0;
+    size_t expanded = 0;
+    size_t localVisited = 0;
+
+    static bool Greater(const HeapEntry& a, const HeapEntry& b) {
+        return a.f > b.f || (a.f == b.f && a.g < b.g);
+    }
+
+    void Prepare(uint32_t nodeCount) {
+        if (nodes.size() < nodeCount) nodes.resize(nodeCount, Node{ 0, 0, START, 0, 0 });
+        if (++generation == 0) {
+            for (Node& node : nodes) node.generation = node.goalGeneration = 0;
+            generation = 1;
+        }
+    }
+
+    void Relax(const MazeHierarchy& hierarchy, uint32_t n, uint32_t g, uint32_t parent, int goalX, int goalY, int width) {
+        Node& node = nodes[n];
+        if (node.generation == generation && node.g <= g) return;
+        node.generation = generation;
+        node.g = g;
+        node.parent = parent;
+        int cell = hierarchy.NodeCell(n);
+        uint32_t h = static_cast<uint32_t>(std::abs(cell % width - goalX) + std::abs(cell / width - goalY));
+        heap.push_back({ g + h, g, n });
+        std::push_heap(heap.begin(), heap.end(), Greater);
+    }
+};
@@ -0,0 +1,87 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "MazeGrid.h"
+
+// 迷宫墙壁的渲染数据 (与 OpenGL 无关，Renderer 负责上传): 线段网格与每格的墙壁位掩码
+// 每条格线只扫描一次: 水平格线 y (0..height) 上的墙来自格 (x, y) 的上墙 (最下一条取格 (x, height - 1) 的下墙)，
+// 竖直格线同理。相邻格共用的内墙因此只生成一次，同一格线上连续的墙再合并成一条线段。
+// 顶点格式与 Renderer 的默认着色器一致: x, y, r, g, b (GL_LINES，每条线段两个顶点)。
+
+// 生成整座迷宫的墙壁线段，写入 vertices (先清空)
+inline void BuildMazeWallLines(const MazeGrid& grid, float cellSize, std::vector<float>& vertices) {
+    static const float WALL_COLOR[3] = { 0.8f, 0.8f, 0.8f };
+    auto AppendLine = [&](float x1, float y1, float x2, float y2) {
+        vertices.insert(vertices.end(), { x1, y1, WALL_COLOR[0], WALL_COLOR[1], WALL_COLOR[2], x2, y2, WALL_COLOR[0], WALL_COLOR[1], WALL_COLOR[2] });
+    };
+    vertices.clear();
+    const int width = grid.width, height = grid.height;
+    if (width <= 0 || height <= 0) return;
+
+    // 水平格线
+    for (int line = 0; line <= height; ++line) {
+        const int y = line < height ? line : height - 1;
+        const int side = line < height ? WALL_TOP : WALL_BOTTOM;
+        for (int x = 0; x < width;) {
+            if (!grid.HasWall(x, y, side)) {
+                ++x;
+                continue;
+            }
+            int end = x + 1;
+            while (end < width && grid.HasWall(end, y, side)) ++end;
+            AppendLine(x * cellSize, line * cellSize, end * cellSize, line * cellSize);
+            x = end;
+        }
+    }
+    // 竖直格线
+    for (int line = 0; line <= width; ++line) {
+        const int x = line < width ? line : width - 1;
+        const int side = line < width ? WALL_LEFT : WALL_RIGHT;
+        for (int y = 0; y < height;) {
+            if (!grid.HasWall(x, y, side)) {
+                ++y;
+                continue;
+            }
+            int end = y + 1;
+            while (end < height && grid.HasWall(x, end, side)) ++end;
+            AppendLine(line * cellSize, y * cellSize, line * cellSize, end * cellSize);
+            y = end;
+        }
+    }
+}
+
+// 墙壁位掩码 (每格 1 字节，上传为 R8UI 纹理): bit0 上墙, bit1 右墙, bit2 下墙, bit3 左墙 (与 WallSide 对应)。
+// 每格自带四面墙，片段着色器只需读一个纹素
+inline void BuildMazeWallMasks(const MazeGrid& grid, std::vector<uint8_t>& masks) {
+    masks.resize(static_cast<size_t>(grid.width) * grid.height);
+    for (int y = 0; y < grid.height; ++y) {
+        uint8_t* row = masks.data() + static_cast<size_t>(y) * grid.width;
+        for (int x = 0; x < grid.width; ++x) {
+            uint8_t mask = 0;
+            for (int side = 0; side < 4; ++side) mask |= static_cast<uint8_t>(grid.HasWall(x, y, side)) << side;
+            row[x] = mask;
+        }
+    }
+}
+
+// 两份同尺寸掩码中不同的格子的包围矩形 [x0, x1) x [y0, y1)；完全相同时返回 false
+inline bool FindDirtyRect(const std::vector<uint8_t>& before, const std::vector<uint8_t>& after, int width, int height,
+                          int& x0, int& y0, int& x1, int& y1) {
+    x0 = width;
+    y0 = height;
+    x1 = y1 = 0;
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* a = before.data() + static_cast<size_t>(y) * width;
+        const uint8_t* b = after.data() + static_cast<size_t>(y) * width;
+        auto first = std::mismatch(a, a + width, b);
+        if (first.first == a + width) continue;
+        int last = width - 1;
+        while (a[last] == b[last]) --last;
+        x0 = std::min(x0, static_cast<int>(first.first - a));
+        x1 = std::max(x1, last + 1);
+        if (y0 == height) y0 = y;
+        y1 = y + 1;
+    }
+    return y1 > 0;
+}
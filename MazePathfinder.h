@@ -0,0 +1,167 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <algorithm>
+#include "MazeGrid.h"
+
+// 网格上的 A* 寻路
+// 节点存放在按格子编号索引的扁平数组中，可以在多次搜索之间复用:
+// 每次搜索递增 generation，节点的 generation 与当前不同即视为未访问，不需要清空数组。
+// 开放集是带位置索引的二叉堆 (节点记录自己在堆中的下标)，支持 O(log n) 的降低键值。
+// 数组只在迷宫变大时扩容，预热之后每次搜索都不再分配内存 (输出路径的 vector 由调用方复用)。
+// 每步代价为 1，启发函数为曼哈顿距离 (可采纳且一致，结果是最短路径)。
+class MazePathfinder {
+public:
+    // 从 (startX, startY) 到 (goalX, goalY) 寻路，成功时 outPath 依次为路径上的格子编号 (y * width + x，含起点和终点)
+    bool FindPath(const MazeGrid& grid, int startX, int startY, int goalX, int goalY, std::vector<int>& outPath) {
+        outPath.clear();
+        expanded = 0;
+        const int width = grid.width;
+        if (!InBounds(grid, startX, startY) || !InBounds(grid, goalX, goalY)) return false;
+        Prepare(static_cast<size_t>(width) * grid.height);
+
+        const uint32_t start = static_cast<uint32_t>(startY * width + startX);
+        const uint32_t goal = static_cast<uint32_t>(goalY * width + goalX);
+        Node& startNode = nodes[start];
+        startNode.generation = generation;
+        startNode.g = 0;
+        startNode.f = Heuristic(startX, startY, goalX, goalY);
+        startNode.parent = start;
+        heap.clear();
+        Push(start);
+
+        while (!heap.empty()) {
+            uint32_t cell = Pop();
+            ++expanded;
+            if (cell == goal) {
+                for (uint32_t c = goal; ; c = nodes[c].parent) {
+                    outPath.push_back(static_cast<int>(c));
+                    if (c == start) break;
+                }
+                std::reverse(outPath.begin(), outPath.end());
+                return true;
+            }
+
+            int x = static_cast<int>(cell % width), y = static_cast<int>(cell / width);
+            uint32_t nextG = nodes[cell].g + 1;
+            for (int dir = 0; dir < 4; ++dir) {
+                if (grid.HasWall(x, y, dir)) continue;
+                int nx = x + DX[dir], ny = y + DY[dir];
+                uint32_t next = static_cast<uint32_t>(ny * width + nx);
+                Node& node = nodes[next];
+                if (node.generation != generation) {
+                    node.generation = generation;
+                    node.g = nextG;
+                    node.f = nextG + Heuristic(nx, ny, goalX, goalY);
+                    node.parent = cell;
+                    Push(next);
+                }
+                else if (nextG < node.g && node.heapIndex != CLOSED) {
+                    node.f -= node.g - nextG;
+                    node.g = nextG;
+                    node.parent = cell;
+                    SiftUp(node.heapIndex);
+                }
+            }
+        }
+        return false;
+    }
+
+    // 上一次搜索展开的节点数
+    size_t LastExpanded() const { return expanded; }
+
+    size_t MemoryBytes() const { return nodes.capacity() * sizeof(Node) + heap.capacity() * sizeof(uint32_t); }
+
+    static uint32_t Heuristic(int x1, int y1, int x2, int y2) {
+        return static_cast<uint32_t>(std::abs(x1 - x2) + std::abs(y1 - y2));
+    }
+
+private:
+    static constexpr int DX[4] = { 0, 1, 0, -1 };
+    static constexpr int DY[4] = { -1, 0, 1, 0 };
+    static constexpr int32_t CLOSED = -1;
+
+    struct Node {
+        uint32_t generation; // 所属的搜索编号
+        uint32_t g;          // 起点到此的步数
+        uint32_t f;          // g + 启发值
+        uint32_t parent;     // 路径上的前一格
+        int32_t heapIndex;   // 在开放堆中的下标 (CLOSED 表示已出堆)
+    };
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> heap; // 开放集 (按 f 排序的最小堆，f 相同时 g 大者优先)
+    uint32_t generation = 0;
+    size_t expanded = 0;
+
+    static bool InBounds(const MazeGrid& grid, int x, int y) {
+        return x >= 0 && x < grid.width && y >= 0 && y < grid.height;
+    }
+
+    // 开始新的一次搜索: 迷宫变大时扩容，generation 回绕时才真正清空
+    void Prepare(size_t cellCount) {
+        if (nodes.size() < cellCount) {
+            nodes.resize(cellCount, Node{ 0, 0, 0, 0, CLOSED });
+            heap.reserve(cellCount); // 开放集不会超过格子数，之后 push_back 不再扩容
+        }
+        if (++generation == 0) {
+            for (Node& node : nodes) node.generation = 0;
+            generation = 1;
+        }
+    }
+
+    bool Less(uint32_t a, uint32_t b) const {
+        const Node& na = nodes[a];
+        const Node& nb = nodes[b];
+        return na.f < nb.f || (na.f == nb.f && na.g > nb.g);
+    }
+
+    void Place(size_t index, uint32_t cell) {
+        heap[index] = cell;
+        nodes[cell].heapIndex = static_cast<int32_t>(index);
+    }
+
+    void Push(uint32_t cell) {
+        heap.push_back(cell);
+        SiftUp(heap.size() - 1);
+    }
+
+    uint32_t Pop() {
+        uint32_t top = heap[0];
+        uint32_t last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            Place(0, last);
+            SiftDown(0);
+        }
+        nodes[top].heapIndex = CLOSED;
+        return top;
+    }
+
+    void SiftUp(size_t index) {
+        uint32_t cell = heap[index];
+        while (index > 0) {
+            size_t parent = (index - 1) / 2;
+            if (!Less(cell, heap[parent])) break;
+            Place(index, heap[parent]);
+            index = parent;
+        }
+        Place(index, cell);
+    }
+
+    void SiftDown(size_t index) {
+        uint32_t cell = heap[index];
+        const size_t count = heap.size();
+        for (;;) {
+            size_t child = index * 2 + 1;
+            if (child >= count) break;
+            if (child + 1 < count && Less(heap[child + 1], heap[child])) ++child;
+            if (!Less(heap[child], cell)) break;
+            Place(index, heap[child]);
+            index = child;
+        }
+        Place(index, cell);
+    }
+};
@@ -0,0 +1,191 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include "MazeGrid.h"
+#include "LineOfSight.h"
+
+// PVS 的构建方式
+enum class PvsMode {
+    Conservative, // 格子级保守可见: 存在一条只朝目标方向前进的连通格子序列即视为可见 (不会漏掉真正可见的格子)
+    Sampled       // 在保守结果中，再用每格 samplesPerAxis^2 个采样点之间的视线精确筛选 (更紧，但可能漏掉擦边的可见)
+};
+
+// PVS 构建参数 (内存与精度的取舍)
+struct PvsSettings {
+    int maxRange = 8;                   // 只记录切比雪夫距离不超过 maxRange 格的可见关系，更远的一律视为不可见
+    PvsMode mode = PvsMode::Conservative;
+    int samplesPerAxis = 2;             // Sampled 模式下每格每轴的采样点数
+    int threadCount = 0;                // 构建线程数，<= 0 时使用全部硬件线程
+};
+
+// 预计算的潜在可见集 (Potentially Visible Set)
+// 墙壁在两次重置之间不会改变，因此可以预先算出 "格子 A 能否看到格子 B"，运行时只需一次位测试。
+// 每格只保存可见格子的包围盒 (相对偏移) 以及盒内的位图，迷宫走廊狭窄，包围盒通常远小于 (2R+1)^2。
+// 视线必定穿过一串两两相邻、之间没有墙、且坐标单调朝目标变化的格子，
+// 所以先对四个象限做动态规划求出这样的 "单调可达" 格子 (保守结果)，Sampled 模式再对其做视线采样。
+// 构建按行分块并行，结果与线程数无关。
+class MazePvs {
+public:
+    void Build(const MazeGrid& grid, const PvsSettings& settings = PvsSettings()) {
+        width = grid.width;
+        height = grid.height;
+        range = std::clamp(settings.maxRange, 0, 127); // 偏移用 int8 保存
+        mode = settings.mode;
+        const int rowsPerBlock = 8;
+        const int blockCount = (height + rowsPerBlock - 1) / rowsPerBlock;
+        entries.assign(static_cast<size_t>(width) * height, Entry());
+
+        // 1. 各行块独立构建，位图先写入块内的缓冲区
+        std::vector<std::vector<uint64_t>> blockBits(blockCount);
+        std::atomic<int> nextBlock(0);
+        auto worker = [&]() {
+            std::vector<uint8_t> reach, visible;
+            for (int b = nextBlock++; b < blockCount; b = nextBlock++) {
+                std::vector<uint64_t>& bits = blockBits[b];
+                size_t bitCount = 0;
+                for (int y = b * rowsPerBlock; y < std::min(height, (b + 1) * rowsPerBlock); ++y) {
+                    for (int x = 0; x < width; ++x) {
+                        BuildCell(grid, settings, x, y, reach, visible, bits, bitCount);
+                    }
+                }
+            }
+        };
+        int threadCount = settings.threadCount > 0 ? settings.threadCount : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<std::thread> threads;
+        for (int i = 1; i < threadCount && i < blockCount; ++i) threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads) thread.join();
+
+        // 2. 按块顺序拼接位图，并把各格的位偏移换算成全局偏移
+        bits.clear();
+        for (int b = 0; b < blockCount; ++b) {
+            uint64_t base = static_cast<uint64_t>(bits.size()) * 64;
+            for (int y = b * rowsPerBlock; y < std::min(height, (b + 1) * rowsPerBlock); ++y) {
+                for (int x = 0; x < width; ++x) entries[static_cast<size_t>(y) * width + x].bitOffset += base;
+            }
+            bits.insert(bits.end(), blockBits[b].begin(), blockBits[b].end());
+        }
+        bits.shrink_to_fit();
+    }
+
+    void Clear() {
+        std::vector<Entry>().swap(entries);
+        std::vector<uint64_t>().swap(bits);
+        width = height = 0;
+    }
+
+    bool IsBuilt(int w, int h) const { return !entries.empty() && w == width && h == height; }
+    int MaxRange() const { return range; }
+    PvsMode Mode() const { return mode; }
+
+    // (bx, by) 是否在 (ax, ay) 的记录范围内 (范围外 CanSee 恒为 false)
+    bool InRange(int ax, int ay, int bx, int by) const {
+        return std::abs(bx - ax) <= range && std::abs(by - ay) <= range;
+    }
+
+    // 格子 A 能否看到格子 B (一次位测试；坐标须在迷宫内)
+    bool CanSee(int ax, int ay, int bx, int by) const {
+        const Entry& entry = entries[static_cast<size_t>(ay) * width + ax];
+        int col = bx - ax - entry.minDx, row = by - ay - entry.minDy;
+        if (col < 0 || row < 0 || col >= entry.boxWidth || row >= entry.boxHeight) return false;
+        uint64_t bit = entry.bitOffset + static_cast<uint64_t>(row * entry.boxWidth + col);
+        return (bits[bit >> 6] >> (bit & 63)) & 1u;
+    }
+
+    size_t MemoryBytes() const { return entries.capacity() * sizeof(Entry) + bits.capacity() * sizeof(uint64_t); }
+
+    // 可见的格子对总数 (含自身)
+    size_t VisiblePairs() const {
+        size_t count = 0;
+        for (uint64_t word : bits) {
+            for (; word; word &= word - 1) ++count;
+        }
+        return count;
+    }
+
+private:
+    // 每格的可见包围盒: 相对偏移、尺寸与位图起点
+    // 位偏移用 64 位: 包围盒最大 255^2 位，大迷宫或大 maxRange 时总位数会超过 2^32
+    struct Entry {
+        uint64_t bitOffset = 0;
+        int8_t minDx = 0, minDy = 0;
+        uint8_t boxWidth = 0, boxHeight = 0;
+    };
+    static_assert(sizeof(Entry) == 16, "PVS entry should stay 16 bytes");
+
+    int width = 0, height = 0;
+    int range = 0;
+    PvsMode mode = PvsMode::Conservative;
+    std::vector<Entry> entries;
+    std::vector<uint64_t> bits;
+
+    // 计算一格的可见集并把包围盒内的位图追加到 out (bitCount 为块内已用的位数)
+    void BuildCell(const MazeGrid& grid, const PvsSettings& settings, int ax, int ay,
+                   std::vector<uint8_t>& reach, std::vector<uint8_t>& visible,
+                   std::vector<uint64_t>& out, size_t& bitCount) {
+        const int side = range * 2 + 1;
+        reach.assign(static_cast<size_t>(side) * side, 0);
+        visible.assign(static_cast<size_t>(side) * side, 0);
+        auto at = [&](int dx, int dy) { return static_cast<size_t>(dy + range) * side + (dx + range); };
+
+        // 四个象限分别做单调可达的动态规划: 从 (dx - sx, dy) 或 (dx, dy - sy) 无墙地走一步到 (dx, dy)
+        reach[at(0, 0)] = 1;
+        for (int sy = -1; sy <= 1; sy += 2) {
+            for (int sx = -1; sx <= 1; sx += 2) {
+                for (int j = 0; j <= range; ++j) {
+                    for (int i = 0; i <= range; ++i) {
+                        if (i == 0 && j == 0) continue;
+                        int dx = i * sx, dy = j * sy;
+                        int x = ax + dx, y = ay + dy;
+                        if (x < 0 || x >= width || y < 0 || y >= height) continue;
+                        bool ok = (i > 0 && reach[at(dx - sx, dy)] && !grid.HasWall(x - sx, y, sx > 0 ? WALL_RIGHT : WALL_LEFT))
+                               || (j > 0 && reach[at(dx, dy - sy)] && !grid.HasWall(x, y - sy, sy > 0 ? WALL_BOTTOM : WALL_TOP));
+                        if (ok) reach[at(dx, dy)] = 1;
+                    }
+                }
+            }
+        }
+
+        // 可见性筛选与包围盒
+        int minDx = 0, maxDx = 0, minDy = 0, maxDy = 0;
+        for (int dy = -range; dy <= range; ++dy) {
+            for (int dx = -range; dx <= range; ++dx) {
+                if (!reach[at(dx, dy)]) continue;
+                if (settings.mode == PvsMode::Sampled && (dx != 0 || dy != 0)
+                    && !SampledVisible(grid, ax, ay, ax + dx, ay + dy, std::max(1, settings.samplesPerAxis))) continue;
+                visible[at(dx, dy)] = 1;
+                minDx = std::min(minDx, dx); maxDx = std::max(maxDx, dx);
+                minDy = std::min(minDy, dy); maxDy = std::max(maxDy, dy);
+            }
+        }
+
+        Entry& entry = entries[static_cast<size_t>(ay) * width + ax];
+        entry.minDx = static_cast<int8_t>(minDx);
+        entry.minDy = static_cast<int8_t>(minDy);
+        entry.boxWidth = static_cast<uint8_t>(maxDx - minDx + 1);
+        entry.boxHeight = static_cast<uint8_t>(maxDy - minDy + 1);
+        entry.bitOffset = bitCount;
+        for (int dy = minDy; dy <= maxDy; ++dy) {
+            for (int dx = minDx; dx <= maxDx; ++dx, ++bitCount) {
+                if ((bitCount >> 6) >= out.size()) out.push_back(0);
+                if (visible[at(dx, dy)]) out[bitCount >> 6] |= 1ull << (bitCount & 63);
+            }
+        }
+    }
+
+    // 两格的采样点之间是否存在一条无遮挡的视线 (格子边长取 1)
+    static bool SampledVisible(const MazeGrid& grid, int ax, int ay, int bx, int by, int samples) {
+        for (int i = 0; i < samples * samples; ++i) {
+            float sx = ax + (i % samples + 0.5f) / samples, sy = ay + (i / samples + 0.5f) / samples;
+            for (int j = 0; j < samples * samples; ++j) {
+                float ex = bx + (j % samples + 0.5f) / samples, ey = by + (j / samples + 0.5f) / samples;
+                if (HasLineOfSight(grid, 1.0f, sx, sy, ex, ey)) return true;
+            }
+        }
+        return false;
+    }
+};
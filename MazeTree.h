@@ -0,0 +1,125 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "MazeGrid.h"
+
+// 迷宫生成树索引
+// 完美迷宫中任意两格之间恰有一条路径，整个迷宫就是以格子为节点的一棵生成树。
+// Build 以 (0, 0) 为根做一次 BFS，记录每格的父节点、深度和跳跃指针；
+// 跳跃指针按深度的 "斜二进制" 规律设置 (每个节点只多存一个指针，内存 O(n))，
+// 沿它可以在 O(log n) 步内找到任意祖先和最近公共祖先，从而得到:
+//   Distance(a, b) = depth[a] + depth[b] - 2 * depth[lca]   两格之间的真实迷宫距离 (步数)
+//   NextStep(a, b)                                          从 a 走向 b 的下一格
+// 查询不做任何搜索，也不分配内存。格子编号为 y * width + x。
+// 只适用于完美迷宫；迷宫改变后需要重新 Build。
+class MazeTree {
+public:
+    // 根据迷宫墙壁建立索引
+    void Build(const MazeGrid& grid) {
+        width = grid.width;
+        height = grid.height;
+        const size_t cellCount = static_cast<size_t>(width) * height;
+        nodes.assign(cellCount, Node{ UNVISITED, 0, 0 });
+        if (cellCount == 0) return;
+
+        // BFS 队列即访问顺序，父节点总是先于子节点出队
+        std::vector<uint32_t> queue;
+        queue.reserve(cellCount);
+        nodes[0] = Node{ 0, 0, 0 };
+        queue.push_back(0);
+        static const int DX[4] = { 0, 1, 0, -1 };
+        static const int DY[4] = { -1, 0, 1, 0 };
+        for (size_t head = 0; head < queue.size(); ++head) {
+            uint32_t cell = queue[head];
+            int x = static_cast<int>(cell % width), y = static_cast<int>(cell / width);
+            for (int dir = 0; dir < 4; ++dir) {
+                if (grid.HasWall(x, y, dir)) continue;
+                uint32_t next = static_cast<uint32_t>((y + DY[dir]) * width + (x + DX[dir]));
+                if (nodes[next].parent != UNVISITED) continue;
+                AddLeaf(next, cell);
+                queue.push_back(next);
+            }
+        }
+    }
+
+    // 释放索引
+    void Clear() {
+        std::vector<Node>().swap(nodes);
+        width = height = 0;
+    }
+
+    // 索引是否与给定尺寸的迷宫对应
+    bool IsBuilt(int w, int h) const {
+        return !nodes.empty() && w == width && h == height;
+    }
+
+    int CellIndex(int x, int y) const { return y * width + x; }
+
+    // 从根 (0, 0) 出发的步数
+    int Depth(int cell) const { return static_cast<int>(nodes[cell].depth); }
+
+    // 两格之间的迷宫距离 (步数)
+    int Distance(int a, int b) const {
+        int lca = Lca(a, b);
+        return Depth(a) + Depth(b) - 2 * Depth(lca);
+    }
+
+    // 从 a 走向 b 的下一格 (a == b 时返回 a)
+    int NextStep(int a, int b) const {
+        if (a == b) return a;
+        int lca = Lca(a, b);
+        if (lca != a) return static_cast<int>(nodes[a].parent); // 先向上走到公共祖先
+        return Ancestor(b, nodes[a].depth + 1);                 // a 是 b 的祖先: 沿 b 的祖先链往下走一步
+    }
+
+    // 最近公共祖先
+    int Lca(int a, int b) const {
+        if (nodes[a].depth > nodes[b].depth) a = Ancestor(a, nodes[b].depth);
+        else if (nodes[b].depth > nodes[a].depth) b = Ancestor(b, nodes[a].depth);
+        // 深度相同的节点跳跃指针的长度也相同，可以同步跳
+        while (a != b) {
+            if (nodes[a].jump != nodes[b].jump) {
+                a = static_cast<int>(nodes[a].jump);
+                b = static_cast<int>(nodes[b].jump);
+            }
+            else {
+                a = static_cast<int>(nodes[a].parent);
+                b = static_cast<int>(nodes[b].parent);
+            }
+        }
+        return a;
+    }
+
+    // cell 在深度 depth 处的祖先 (depth 不大于 cell 的深度)
+    int Ancestor(int cell, uint32_t depth) const {
+        while (nodes[cell].depth > depth) {
+            const Node& node = nodes[cell];
+            cell = static_cast<int>(nodes[node.jump].depth >= depth ? node.jump : node.parent);
+        }
+        return cell;
+    }
+
+    size_t MemoryBytes() const { return nodes.capacity() * sizeof(Node); }
+
+private:
+    static const uint32_t UNVISITED = 0xFFFFFFFFu;
+
+    struct Node {
+        uint32_t parent; // 父节点 (根的父节点是自己)
+        uint32_t jump;   // 跳跃指针 (某个祖先)
+        uint32_t depth;  // 深度
+    };
+
+    int width = 0, height = 0;
+    std::vector<Node> nodes;
+
+    // 挂上叶子 v: 若父节点的两段跳跃长度相同，则合并为一段更长的跳跃，否则只跳一步
+    void AddLeaf(uint32_t v, uint32_t p) {
+        const Node& parentNode = nodes[p];
+        const Node& jump1 = nodes[parentNode.jump];
+        const Node& jump2 = nodes[jump1.jump];
+        bool merge = parentNode.depth - jump1.depth == jump1.depth - jump2.depth;
+        nodes[v] = Node{ p, merge ? jump1.jump : p, parentNode.depth + 1 };
+    }
+};
@@ -1,11 +1,13 @@
 #include "Monster.h"
 #include "Player.h" // 包含 Player 定义
+#include "PathService.h"
 #include <cmath>   // 用于 sqrt, abs, floor
 #include <algorithm> // 用于 std::reverse
 #include <climits> // 用于 INT_MAX
 #include <cstring> // 用于 memset (可选, 但对于重置数组很有用)
 #include <random>  // 用于随机数生成
 #include <glm/gtc/constants.hpp> // 可能需要这个头文件用于 PI
+#include "LineOfSight.h"
 
 // --- 辅助函数: Monster 移动的简单墙体碰撞检测 ---
 bool Monster::CheckWallCollision(const MazeGenerator& mazeGen, float newX, float newY, float cellSize) const {
@@ -18,7 +20,7 @@ bool Monster::CheckWallCollision(const MazeGenerator& mazeGen, float newX, float
         return true; // 撞墙
     }
 
-    const Cell& currentCell = mazeGen.maze[gridY][gridX];
+    const MazeGrid& grid = mazeGen.maze;
 
     // 检查相对于单元格边界的位置
     float cellLeft = gridX * cellSize;
@@ -33,10 +35,10 @@ bool Monster::CheckWallCollision(const MazeGenerator& mazeGen, float newX, float
     float monsterBottom = newY + radius;
 
     // 如果怪物边界超出单元格边界并且该边存在墙壁，则发生碰撞
-    if (currentCell.walls[3] && monsterLeft < cellLeft + 1.0f) return true; // 左墙 (添加小缓冲区)
-    if (currentCell.walls[1] && monsterRight > cellRight - 1.0f) return true; // 右墙
-    if (currentCell.walls[0] && monsterTop < cellTop + 1.0f) return true; // 上墙
-    if (currentCell.walls[2] && monsterBottom > cellBottom - 1.0f) return true; // 下墙
+    if (grid.HasWall(gridX, gridY, WALL_LEFT) && monsterLeft < cellLeft + 1.0f) return true; // 左墙 (添加小缓冲区)
+    if (grid.HasWall(gridX, gridY, WALL_RIGHT) && monsterRight > cellRight - 1.0f) return true; // 右墙
+    if (grid.HasWall(gridX, gridY, WALL_TOP) && monsterTop < cellTop + 1.0f) return true; // 上墙
+    if (grid.HasWall(gridX, gridY, WALL_BOTTOM) && monsterBottom > cellBottom - 1.0f) return true; // 下墙
 
     return false; // 无碰撞
 }
@@ -97,7 +99,7 @@ Monster::Monster(float x, float y)
 }
 
 // --- 更新怪物状态 ---
-void Monster::Update(float deltaTime, const Player& player, const MazeGenerator& mazeGen, float cellSize) {
+void Monster::Update(float deltaTime, const Player& player, const MazeGenerator& mazeGen, float cellSize, const FlowField* flowField) {
     if (frozen) {
         // 冻结状态: 不移动
         return;
@@ -113,8 +115,16 @@ void Monster::Update(float deltaTime, const Player& player, const MazeGenerator&
     bool playerInRange = distanceToPlayer < detectionRange;
     bool playerVisible = false;
     if (playerInRange) {
+        // 先查潜在可见集: 两格之间不可能可见时跳过视线检测 (迷宫中绝大多数情况)
+        int cellX = static_cast<int>(floor(position.x / cellSize));
+        int cellY = static_cast<int>(floor(position.y / cellSize));
+        const MazePvs& pvs = mazeGen.pvs;
+        bool culled = pvs.IsBuilt(mazeGen.width, mazeGen.height)
+            && cellX >= 0 && cellX < mazeGen.width && cellY >= 0 && cellY < mazeGen.height
+            && player.cellX >= 0 && player.cellX < mazeGen.width && player.cellY >= 0 && player.cellY < mazeGen.height
+            && pvs.InRange(cellX, cellY, player.cellX, player.cellY) && !pvs.CanSee(cellX, cellY, player.cellX, player.cellY);
         // 检查视线是否被阻挡
-        playerVisible = HasLineOfSight(mazeGen, position.x, position.y, player.position.x, player.position.y, cellSize);
+        playerVisible = !culled && HasLineOfSight(mazeGen, position.x, position.y, player.position.x, player.position.y, cellSize);
     }
 
     if (playerInRange && playerVisible) {
@@ -137,8 +147,31 @@ void Monster::Update(float deltaTime, const Player& player, const MazeGenerator&
     float newX = position.x;
     float newY = position.y;
 
-    if (state == MonsterState::CHASING) {
-        // --- 追逐模式: 向玩家移动 ---
+    wantedGoal = -1;
+    if (state != MonsterState::CHASING && pathGoal >= 0) {
+        // 不再追逐: 丢弃路径，迟到的结果会因编号不符被忽略
+        DropPath();
+        pathTicket = 0;
+    }
+
+    if (state == MonsterState::CHASING && ChaseTowardPlayer(mazeGen, player, flowField, stepDistance, cellSize, newX, newY)) {
+        // --- 追逐模式: 沿迷宫中的最短路径向玩家移动 ---
+        if (CheckWallCollision(mazeGen, newX, newY, cellSize)) {
+            newX = position.x;
+            newY = position.y;
+        }
+    }
+    else if (state == MonsterState::CHASING && FollowPath(mazeGen, player, stepDistance, cellSize, newX, newY)) {
+        // --- 追逐模式 (没有流场和生成树索引时): 沿寻路服务交付的路径移动 ---
+        if (CheckWallCollision(mazeGen, newX, newY, cellSize)) {
+            // 路径与当前位置之间隔着墙: 丢弃路径，下一帧从所在格重新请求
+            newX = position.x;
+            newY = position.y;
+            DropPath();
+        }
+    }
+    else if (state == MonsterState::CHASING) {
+        // --- 追逐模式 (没有流场和生成树索引，且路径尚未到达时): 贪心地向玩家移动 ---
         // 优先沿距离差较大的轴移动
         if (abs(dx_to_player) > abs(dy_to_player)) {
             // 优先尝试水平移动
@@ -240,132 +273,258 @@ void Monster::Update(float deltaTime, const Player& player, const MazeGenerator&
     position.y = newY;
 }
 
-// --- 未使用的寻路函数的占位符实现 ---
-// 如果当前不使用 A* 寻路，这些可以删除或留空。
-float Monster::Heuristic(int x1, int y1, int x2, int y2) const {
-    // 曼哈顿距离启发式函数
-    return static_cast<float>(abs(x1 - x2) + abs(y1 - y2));
+// --- 粗略的格子级巡逻 ---
+void Monster::UpdateCoarse(float deltaTime, const MazeGenerator& mazeGen, float cellSize) {
+    if (frozen) return;
+    state = MonsterState::PATROLLING;
+    currentSpeed = baseSpeed;
+    visible = false; // 只有远处的怪物会走这条路径
+
+    int cellX = std::clamp(static_cast<int>(floor(position.x / cellSize)), 0, mazeGen.width - 1);
+    int cellY = std::clamp(static_cast<int>(floor(position.y / cellSize)), 0, mazeGen.height - 1);
+    const MazeGrid& grid = mazeGen.maze;
+    static thread_local std::mt19937 gen(std::random_device{}()); // 可能在多个工作线程上同时调用
+
+    coarseTravel += baseSpeed * deltaTime;
+    for (; coarseTravel >= cellSize; coarseTravel -= cellSize) {
+        if (currentDirection == NONE || grid.HasWall(cellX, cellY, currentDirection)) {
+            // 换一个相通的方向，尽量不掉头 (死胡同时只能掉头)
+            Direction options[4];
+            int optionCount = 0;
+            for (int d = UP; d <= LEFT; ++d) {
+                if (!grid.HasWall(cellX, cellY, d) && (currentDirection == NONE || d != ((currentDirection + 2) & 3))) options[optionCount++] = static_cast<Direction>(d);
+            }
+            if (optionCount == 0 && currentDirection != NONE && !grid.HasWall(cellX, cellY, (currentDirection + 2) & 3)) {
+                options[optionCount++] = static_cast<Direction>((currentDirection + 2) & 3);
+            }
+            if (optionCount == 0) {
+                currentDirection = NONE;
+                coarseTravel = 0.0f;
+                break;
+            }
+            currentDirection = options[gen() % optionCount];
+        }
+        cellX += (currentDirection == RIGHT) - (currentDirection == LEFT);
+        cellY += (currentDirection == DOWN) - (currentDirection == UP);
+    }
+    position = glm::vec2((cellX + 0.5f) * cellSize, (cellY + 0.5f) * cellSize);
 }
 
-bool Monster::IsPathBlockedByWall(const MazeGenerator& /*mazeGen*/, float /*fromX*/, float /*fromY*/, float /*toX*/, float /*toY*/, float /*cellSize*/) const {
-    // 占位符，此修订版逻辑中未使用
-    return false;
+// --- 沿最短路径追逐 ---
+// 下一格优先取共享流场 (所有怪物共用一次 BFS)，其次取生成树索引；两者都没有时返回 false。
+// 每帧向下一格移动: 先把另一轴对齐到当前格中心 (保证不蹭到通道两侧的墙)，再沿通道前进。
+// 与玩家同格时直接向玩家移动。
+bool Monster::ChaseTowardPlayer(const MazeGenerator& mazeGen, const Player& player, const FlowField* flowField, float stepDistance, float cellSize, float& newX, float& newY) const {
+    int cellX = std::clamp(static_cast<int>(floor(position.x / cellSize)), 0, mazeGen.width - 1);
+    int cellY = std::clamp(static_cast<int>(floor(position.y / cellSize)), 0, mazeGen.height - 1);
+    int targetX = std::clamp(player.cellX, 0, mazeGen.width - 1);
+    int targetY = std::clamp(player.cellY, 0, mazeGen.height - 1);
+
+    int next;
+    if (flowField && flowField->IsValid(mazeGen.width, mazeGen.height)) {
+        next = flowField->NextCell(cellX, cellY);
+    }
+    else if (mazeGen.tree.IsBuilt(mazeGen.width, mazeGen.height)) {
+        const MazeTree& tree = mazeGen.tree;
+        next = tree.NextStep(tree.CellIndex(cellX, cellY), tree.CellIndex(targetX, targetY));
+    }
+    else {
+        return false;
+    }
+    if (next < 0) next = cellY * mazeGen.width + cellX; // 已在目标格
+
+    // 朝 target 移动最多 budget，返回实际移动的距离
+    auto approach = [](float& value, float target, float budget) {
+        float delta = std::clamp(target - value, -budget, budget);
+        value += delta;
+        return std::abs(delta);
+    };
+
+    float budget = stepDistance;
+    float centerX = (cellX + 0.5f) * cellSize;
+    float centerY = (cellY + 0.5f) * cellSize;
+    int nextX = next % mazeGen.width;
+    int nextY = next / mazeGen.width;
+
+    if (nextX != cellX) {
+        budget -= approach(newY, centerY, budget);
+        approach(newX, (nextX + 0.5f) * cellSize, budget);
+    }
+    else if (nextY != cellY) {
+        budget -= approach(newX, centerX, budget);
+        approach(newY, (nextY + 0.5f) * cellSize, budget);
+    }
+    else {
+        // 同一格内没有墙，直接靠近玩家
+        glm::vec2 toPlayer = player.position - position;
+        float length = glm::length(toPlayer);
+        if (length > 0.0f) {
+            glm::vec2 step = toPlayer * (std::min(budget, length) / length);
+            newX += step.x;
+            newY += step.y;
+        }
+    }
+    return true;
 }
 
-bool Monster::FindPath(const MazeGenerator& /*mazeGen*/, float /*cellSize*/, const glm::vec2& /*targetPos*/) {
-    // 占位符，此修订版逻辑中未使用
-    path.clear();
-    return false; // 表示未使用/寻路失败
+// --- 寻路函数实现 ---
+float Monster::Heuristic(int x1, int y1, int x2, int y2) const {
+    // 曼哈顿距离启发式函数
+    return static_cast<float>(MazePathfinder::Heuristic(x1, y1, x2, y2));
 }
 
-// --- 新增: 视线检测 (Line-of-Sight, LOS) 实现 ---
-bool Monster::HasLineOfSight(const MazeGenerator& mazeGen, float startX, float startY, float endX, float endY, float cellSize) const {
-    // 适应于基于网格碰撞检测的 DDA (Digital Differential Analyzer) 算法
-
-    float dx = endX - startX;
-    float dy = endY - startY;
-    // 根据网格大小估算步数
-    int steps = static_cast<int>(std::ceil(std::max(std::abs(dx), std::abs(dy)) / cellSize));
-
-    if (steps == 0) steps = 1; // 确保至少检查起始单元格
-
-    // 计算每一步在 X 和 Y 方向上的增量
-    float xIncrement = dx / steps;
-    float yIncrement = dy / steps;
-
-    float currentX = startX;
-    float currentY = startY;
+bool Monster::IsPathBlockedByWall(const MazeGenerator& mazeGen, float fromX, float fromY, float toX, float toY, float cellSize) const {
+    int fromCellX = static_cast<int>(floor(fromX / cellSize));
+    int fromCellY = static_cast<int>(floor(fromY / cellSize));
+    int toCellX = static_cast<int>(floor(toX / cellSize));
+    int toCellY = static_cast<int>(floor(toY / cellSize));
+    if (fromCellX == toCellX && fromCellY == toCellY) return false; // 同一格内没有墙
+
+    // 相邻格子: 直接查两格之间的墙
+    int dx = toCellX - fromCellX, dy = toCellY - fromCellY;
+    if (abs(dx) + abs(dy) == 1 && fromCellX >= 0 && fromCellX < mazeGen.width && fromCellY >= 0 && fromCellY < mazeGen.height) {
+        int side = dx == 1 ? WALL_RIGHT : dx == -1 ? WALL_LEFT : dy == 1 ? WALL_BOTTOM : WALL_TOP;
+        return mazeGen.maze.HasWall(fromCellX, fromCellY, side);
+    }
+    // 更远的两点: 按视线判断
+    return !HasLineOfSight(mazeGen, fromX, fromY, toX, toY, cellSize);
+}
 
-    // 遍历光线路径上的步骤
-    for (int i = 0; i <= steps; ++i) {
-        // 计算当前点所在的网格单元格
-        int gridX = static_cast<int>(std::floor(currentX / cellSize));
-        int gridY = static_cast<int>(std::floor(currentY / cellSize));
+// 每个线程共用一个分层寻路器
+static HierarchicalPathfinder& ThreadHierarchicalPathfinder() {
+    static thread_local HierarchicalPathfinder hierarchicalPathfinder;
+    return hierarchicalPathfinder;
+}
 
-        // 边界检查
-        if (gridX < 0 || gridX >= mazeGen.width || gridY < 0 || gridY >= mazeGen.height) {
-            // 将迷宫外区域视为阻挡
-            return false;
-        }
+void Monster::RequestPath(PathService& service, uint32_t self, const MazeGenerator& mazeGen, float cellSize) {
+    if (wantedGoal < 0 || wantedGoal == pathGoal) return;
+    int startX = static_cast<int>(floor(position.x / cellSize));
+    int startY = static_cast<int>(floor(position.y / cellSize));
+    int startCell = startX >= 0 && startX < mazeGen.width && startY >= 0 && startY < mazeGen.height ? startY * mazeGen.width + startX : -1;
+    pathGoal = wantedGoal;
+    pathTicket = service.Submit(self, startCell, wantedGoal);
+}
 
-        const Cell& cell = mazeGen.maze[gridY][gridX];
-
-        // 定义单元格边界
-        float cellLeft = gridX * cellSize;
-        float cellRight = (gridX + 1) * cellSize;
-        float cellTop = gridY * cellSize;
-        float cellBottom = (gridY + 1) * cellSize;
-
-        // --- 检查光线段在此单元格内是否穿过任何墙壁 ---
-
-        // 1. 检查垂直墙壁穿越 (左/右)
-        if (xIncrement > 0) { // 光线向右移动
-            // 潜在与下一单元格左墙的交点
-            if (gridX + 1 < mazeGen.width) {
-                float t = (cellRight - currentX) / xIncrement;
-                // 检查交点是否在线段上 (0 <= t <= 1)
-                if (t >= 0 && t <= 1) {
-                    float intersectY = currentY + t * yIncrement;
-                    // 检查交点 Y 坐标是否在墙的垂直跨度内
-                    if (intersectY >= cellTop && intersectY <= cellBottom) {
-                        // 检查墙壁是否存在
-                        if (mazeGen.maze[gridY][gridX].walls[1]) { // 当前单元格的右墙
-                            return false; // 被右墙阻挡
-                        }
-                    }
-                }
-            }
-        }
-        else if (xIncrement < 0) { // 光线向左移动
-            // 潜在与上一单元格右墙的交点
-            if (gridX - 1 >= 0) {
-                float t = (cellLeft - currentX) / xIncrement;
-                if (t >= 0 && t <= 1) {
-                    float intersectY = currentY + t * yIncrement;
-                    if (intersectY >= cellTop && intersectY <= cellBottom) {
-                        if (mazeGen.maze[gridY][gridX].walls[3]) { // 当前单元格的左墙
-                            return false; // 被左墙阻挡
-                        }
-                    }
-                }
+void Monster::ReceivePath(const PathResult& result, const MazeGenerator& mazeGen, float cellSize) {
+    if (result.ticket != pathTicket) return; // 已被更新的请求取代
+    pathTicket = 0;
+    path.clear();
+    currentPathIndex = 0;
+    waypoints.clear();
+    nextWaypoint = 0;
+    if (result.cells.empty()) return; // 不可达: 保持原有行为，直到终点改变
+
+    // 路径从提交请求时所在的格子出发，等待结果期间怪物可能已经走到别的格子
+    int cellX = static_cast<int>(floor(position.x / cellSize));
+    int cellY = static_cast<int>(floor(position.y / cellSize));
+    int current = cellX >= 0 && cellX < mazeGen.width && cellY >= 0 && cellY < mazeGen.height ? cellY * mazeGen.width + cellX : -1;
+
+    if (result.waypoints) {
+        // 分层寻路: 只得到途经各簇的路点，先展开到第一个簇边界。
+        // 已离开起点时，只要还在起点所在的簇内，就把当前格作为新的起点接在前面 (簇内展开时再找路)
+        const MazeHierarchy& hierarchy = mazeGen.hierarchy;
+        if (current != result.cells.front()) {
+            if (current < 0 || !hierarchy.IsBuilt(mazeGen.width, mazeGen.height)
+                || hierarchy.ClusterOf(current) != hierarchy.ClusterOf(result.cells.front())) {
+                pathGoal = -1; // 下一帧从当前格重新请求
+                return;
             }
+            waypoints.push_back(current);
         }
+        waypoints.insert(waypoints.end(), result.cells.begin(), result.cells.end());
+        nextWaypoint = 1;
+        ExtendPath(mazeGen, cellSize);
+        return;
+    }
+    // 从当前格在路径上的位置开始 (不在路径上时重新请求)，跳过当前格，依次记录后续各格中心
+    auto from = std::find(result.cells.begin(), result.cells.end(), current);
+    if (from == result.cells.end()) {
+        pathGoal = -1;
+        return;
+    }
+    for (size_t i = static_cast<size_t>(from - result.cells.begin()) + 1; i < result.cells.size(); ++i) {
+        int cell = result.cells[i];
+        path.emplace_back((cell % mazeGen.width + 0.5f) * cellSize, (cell / mazeGen.width + 0.5f) * cellSize);
+    }
+}
 
-        // 2. 检查水平墙壁穿越 (上/下)
-        if (yIncrement > 0) { // 光线向下移动
-            // 潜在与下一单元格顶墙的交点
-            if (gridY + 1 < mazeGen.height) {
-                float t = (cellBottom - currentY) / yIncrement;
-                if (t >= 0 && t <= 1) {
-                    float intersectX = currentX + t * xIncrement;
-                    if (intersectX >= cellLeft && intersectX <= cellRight) {
-                        if (mazeGen.maze[gridY][gridX].walls[2]) { // 当前单元格的底墙
-                            return false; // 被底墙阻挡
-                        }
-                    }
-                }
-            }
+bool Monster::FollowPath(const MazeGenerator& mazeGen, const Player& player, float stepDistance, float cellSize, float& newX, float& newY) {
+    if (player.cellX >= 0 && player.cellX < mazeGen.width && player.cellY >= 0 && player.cellY < mazeGen.height) {
+        wantedGoal = player.cellY * mazeGen.width + player.cellX;
+    }
+    glm::vec2 current = position;
+    bool exhausted = false;
+    while (stepDistance > 0.0f) {
+        if (currentPathIndex >= path.size() && !ExtendPath(mazeGen, cellSize)) {
+            exhausted = true;
+            break;
         }
-        else if (yIncrement < 0) { // 光线向上移动
-            // 潜在与上一单元格底墙的交点
-            if (gridY - 1 >= 0) {
-                float t = (cellTop - currentY) / yIncrement;
-                if (t >= 0 && t <= 1) {
-                    float intersectX = currentX + t * xIncrement;
-                    if (intersectX >= cellLeft && intersectX <= cellRight) {
-                        if (mazeGen.maze[gridY][gridX].walls[0]) { // 当前单元格的顶墙
-                            return false; // 被顶墙阻挡
-                        }
-                    }
-                }
-            }
+        glm::vec2 offset = path[currentPathIndex] - current;
+        float distance = sqrt(offset.x * offset.x + offset.y * offset.y);
+        if (distance <= stepDistance) {
+            current = path[currentPathIndex++];
+            stepDistance -= distance;
+            continue;
         }
+        current += offset * (stepDistance / distance);
+        stepDistance = 0.0f;
+    }
+    if (exhausted) {
+        // 路径已走完 (或展开失败): 丢弃路径。已在终点格时保留 pathGoal，玩家不换格就不再重复提交同一请求；
+        // 否则下次 Update 从所在格重新请求
+        int cellX = static_cast<int>(floor(current.x / cellSize));
+        int cellY = static_cast<int>(floor(current.y / cellSize));
+        const int goal = pathGoal;
+        DropPath();
+        if (goal >= 0 && cellY * mazeGen.width + cellX == goal && cellX >= 0 && cellX < mazeGen.width) pathGoal = goal;
+    }
+    // 本帧没有移动 (步长为 0 或已在路径末端) 时不丢弃路径
+    if (current == position) return false;
+    newX = current.x;
+    newY = current.y;
+    return true;
+}
+
+void Monster::DropPath() {
+    path.clear();
+    currentPathIndex = 0;
+    waypoints.clear();
+    nextWaypoint = 0;
+    pathGoal = -1;
+}
 
-        // 沿着光线移动到下一个采样点
-        currentX += xIncrement;
-        currentY += yIncrement;
+bool Monster::ExtendPath(const MazeGenerator& mazeGen, float cellSize) {
+    static thread_local std::vector<int> cells;
+    if (nextWaypoint == 0 || nextWaypoint >= waypoints.size()) return false;
+    if (!mazeGen.hierarchy.IsBuilt(mazeGen.width, mazeGen.height)) {
+        // 迷宫已重新生成 (抽象图被清空或尚未重建)，路点失效；此时 ClusterOf 没有意义
+        waypoints.clear();
+        nextWaypoint = 0;
+        return false;
     }
 
-    // 如果在整个遍历过程中都没有撞到墙，则视线畅通
-    return true;
+    // 先跨过簇边界 (相邻两格)，再展开新簇内到出口的一段
+    cells.clear();
+    const MazeHierarchy& hierarchy = mazeGen.hierarchy;
+    while (nextWaypoint < waypoints.size()) {
+        int from = waypoints[nextWaypoint - 1], to = waypoints[nextWaypoint];
+        bool crossing = hierarchy.ClusterOf(from) != hierarchy.ClusterOf(to);
+        if (!ThreadHierarchicalPathfinder().RefineSegment(hierarchy, mazeGen.maze, from, to, cells)) {
+            waypoints.clear(); // 迷宫已改变，路点失效
+            nextWaypoint = 0;
+            break;
+        }
+        ++nextWaypoint;
+        if (!crossing) break;
+    }
+    for (int cell : cells) {
+        path.emplace_back((cell % mazeGen.width + 0.5f) * cellSize, (cell / mazeGen.width + 0.5f) * cellSize);
+    }
+    return !cells.empty();
+}
+
+// --- 新增: 视线检测 (Line-of-Sight, LOS) 实现 ---
+// 精确的逐格边界遍历 (见 LineOfSight.h)，不会漏掉擦过格角的穿墙
+bool Monster::HasLineOfSight(const MazeGenerator& mazeGen, float startX, float startY, float endX, float endY, float cellSize) const {
+    return ::HasLineOfSight(mazeGen.maze, cellSize, startX, startY, endX, endY);
 }
\ No newline at end of file
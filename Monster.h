@@ -4,8 +4,12 @@
 #include <queue>  // 用于 A* 中的优先队列 (priority_queue)
 #include <functional> // 用于 std::function
 #include "MazeGenerator.h" // 需要访问迷宫结构体
+#include "MazePathfinder.h"
+#include "FlowField.h"
 
 class Player; // 前向声明
+class PathService;
+struct PathResult;
 
 // 怪物状态枚举
 enum class MonsterState {
@@ -22,6 +26,11 @@ public:
     float currentSpeed = 80.0f; // 当前速度
     std::vector<glm::vec2> path; // 要跟随的路径 (用于寻路)
     size_t currentPathIndex = 0; // 路径中下一个节点的索引
+    std::vector<int> waypoints; // 分层寻路的路点 (格子编号)，path 只展开到下一簇
+    size_t nextWaypoint = 0;    // 下一个尚未展开的路点
+    int wantedGoal = -1;        // Update 中希望寻路前往的格子 (-1 表示不需要)，由主线程据此提交请求
+    int pathGoal = -1;          // 当前路径或进行中请求的终点格
+    uint32_t pathTicket = 0;    // 进行中请求的编号 (0 表示没有)
     bool frozen = false; // 是否被冻结
     bool visible = true; // 是否可见
     float detectionRange = 200.0f; // 探测范围
@@ -37,6 +46,7 @@ public:
     enum Direction { NONE = -1, UP = 0, RIGHT = 1, DOWN = 2, LEFT = 3 };
     Direction currentDirection = NONE; // 当前移动方向
     float directionChangeTimer = 0.0f; // 方向改变定时器
+    float coarseTravel = 0.0f; // 粗略模拟 (UpdateCoarse) 中尚未走完一格的累计距离
     const float minDirectionChangeInterval = 0.5f; // 最短方向改变间隔 (秒)
     const float maxDirectionChangeInterval = 2.0f; // 最长方向改变间隔 (秒)
 
@@ -44,18 +54,24 @@ public:
     Monster(float x, float y);
 
     // 更新怪物状态
-    // 传递 MazeGenerator 引用用于寻路/碰撞检测
-    void Update(float deltaTime, const Player& player, const MazeGenerator& mazeGen, float cellSize);
+    // 传递 MazeGenerator 引用用于寻路/碰撞检测；flowField 为朝向玩家的共享流场 (可为空)
+    void Update(float deltaTime, const Player& player, const MazeGenerator& mazeGen, float cellSize, const FlowField* flowField = nullptr);
+
+    // 粗略的格子级巡逻 (远离玩家时由 AI LOD 调度使用): 不做视线检测与碰撞，
+    // 按巡逻速度累计距离，每满一格就沿当前方向跳到相邻且相通的格子中心，受阻时随机换向
+    void UpdateCoarse(float deltaTime, const MazeGenerator& mazeGen, float cellSize);
+
+    // 向寻路服务提交 wantedGoal 的请求 (只能在主线程调用)；终点未变时不重复提交，结果到达前保持原有行为
+    void RequestPath(PathService& service, uint32_t self, const MazeGenerator& mazeGen, float cellSize);
+
+    // 接收寻路服务交付的结果 (编号不是最近一次请求的结果会被忽略)，写入 path
+    void ReceivePath(const PathResult& result, const MazeGenerator& mazeGen, float cellSize);
+
+    // 分层寻路时 path 只含即将进入的一簇；走完后调用本函数展开下一簇并追加到 path，没有剩余路点时返回 false
+    bool ExtendPath(const MazeGenerator& mazeGen, float cellSize);
 
 private:
-    // --- 寻路结构体 (如果使用) ---
-    struct Node {
-        int x, y;
-        float g, h, f; // g: 从起点到当前点的实际成本, h: 到目标点的启发式估算成本 (Manhattan distance), f: 总成本 (g+h)
-        Node* parent;
-        // 为了基于 'f' 值构建最小堆 (min-heap)，重载大于运算符
-        bool operator>(const Node& other) const { return f > other.f; }
-    };
+    // 寻路节点存放在 MazePathfinder 的扁平数组中 (见 MazePathfinder.h)，不再为每个节点单独分配
 
     // --- 辅助函数 ---
 
@@ -68,17 +84,24 @@ private:
     // 检查从当前位置向给定方向移动一步是否可行
     bool CanMoveInDirection(const MazeGenerator& mazeGen, Direction dir, float cellSize) const;
 
+    // 沿共享流场或迷宫生成树 (mazeGen.tree) 向玩家所在格移动一步，结果写入 newX/newY；两者都不可用时返回 false
+    bool ChaseTowardPlayer(const MazeGenerator& mazeGen, const Player& player, const FlowField* flowField, float stepDistance, float cellSize, float& newX, float& newY) const;
+
     // --- 新增: 视线检测 (Line-of-Sight, LOS) ---
     // 检查从 (startX, startY) 到 (endX, endY) 的线段是否与迷宫中的任何墙壁相交。
     bool HasLineOfSight(const MazeGenerator& mazeGen, float startX, float startY, float endX, float endY, float cellSize) const;
 
-    // --- 寻路函数 (如果使用) ---
+    // --- 寻路函数 ---
 
     // 计算两点之间 (网格坐标) 的曼哈顿距离启发式值 (Manhattan distance heuristic)。
     float Heuristic(int x1, int y1, int x2, int y2) const;
 
-    // 使用 A* (或更简单的方法) 从怪物当前位置寻找一条通往目标点的路径。
-    bool FindPath(const MazeGenerator& mazeGen, float cellSize, const glm::vec2& targetPos);
+    // 路径由 PathService 异步计算 (见 RequestPath / ReceivePath)，不再在 Update 中同步搜索。
+    // 把玩家所在格记为 wantedGoal，并沿 path 移动一步，结果写入 newX/newY；本帧没有移动 (路径已走完、尚未到达或步长为 0) 时返回 false
+    bool FollowPath(const MazeGenerator& mazeGen, const Player& player, float stepDistance, float cellSize, float& newX, float& newY);
+
+    // 丢弃路径与路点，并清除 pathGoal 使下一次 RequestPath 重新提交
+    void DropPath();
 
     // 检查从 (fromX, fromY) 移动到 (toX, toY) 是否会穿过迷宫中的一堵墙。
     bool IsPathBlockedByWall(const MazeGenerator& mazeGen, float fromX, float fromY, float toX, float toY, float cellSize) const;
@@ -0,0 +1,223 @@
+#include "MonsterSwarm.h"
+#include "LineOfSight.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SWARM_USE_SSE 1
+#else
+#define SWARM_USE_SSE 0
+#endif
+
+namespace {
+const int DX[4] = { 0, 1, 0, -1 };
+const int DY[4] = { -1, 0, 1, 0 };
+}
+
+void MonsterSwarm::Clear() {
+    count = 0;
+    posX.clear(); posY.clear();
+    targetX.clear(); targetY.clear();
+    baseSpeed.clear(); chaseSpeed.clear();
+    rangeSq.clear();
+    freezeTimer.clear(); turnTimer.clear();
+    distanceSq.clear();
+    chaseMask.clear();
+    direction.clear();
+    groupFlags.clear();
+}
+
+void MonsterSwarm::Add(int cellX, int cellY, float cellSize, float patrolSpeed, float chasingSpeed, float detectionRange) {
+    if (count % LANES == 0) {
+        // 新开一组: 所有数组补齐到 LANES 的倍数，补齐的怪物永远不在探测范围内，也不会被逐个处理
+        size_t padded = count + LANES;
+        posX.resize(padded, 0.0f); posY.resize(padded, 0.0f);
+        targetX.resize(padded, 0.0f); targetY.resize(padded, 0.0f);
+        baseSpeed.resize(padded, 0.0f); chaseSpeed.resize(padded, 0.0f);
+        rangeSq.resize(padded, -1.0f);
+        freezeTimer.resize(padded, 0.0f); turnTimer.resize(padded, 0.0f);
+        distanceSq.resize(padded, 0.0f);
+        chaseMask.resize(padded, 0u);
+        direction.resize(padded, -1);
+        groupFlags.resize(padded / LANES, 0);
+    }
+    size_t i = count++;
+    posX[i] = targetX[i] = (cellX + 0.5f) * cellSize;
+    posY[i] = targetY[i] = (cellY + 0.5f) * cellSize;
+    baseSpeed[i] = patrolSpeed;
+    chaseSpeed[i] = chasingSpeed;
+    rangeSq[i] = detectionRange * detectionRange;
+    freezeTimer[i] = 0.0f;
+    turnTimer[i] = 0.0f;
+    chaseMask[i] = 0u;
+    direction[i] = -1;
+}
+
+void MonsterSwarm::FreezeAll(float seconds) {
+    std::fill(freezeTimer.begin(), freezeTimer.begin() + count, seconds);
+}
+
+void MonsterSwarm::Update(float deltaTime, float playerX, float playerY, int playerCellX, int playerCellY,
+                          const MazeGenerator& mazeGen, float cellSize, const FlowField* flowField) {
+    scalarCount = 0;
+    if (count == 0) return;
+
+    // 1. SIMD: 计时器、到玩家的距离、探测范围与路点到达标记
+    UpdateTimersAndDistances(deltaTime, playerX, playerY);
+
+    // 2. 标量: 只处理在探测范围内 (视线检测) 或已到达路点 (选下一个路点) 的怪物
+    const MazePvs& pvs = mazeGen.pvs;
+    const bool usePvs = pvs.IsBuilt(mazeGen.width, mazeGen.height)
+        && playerCellX >= 0 && playerCellX < mazeGen.width && playerCellY >= 0 && playerCellY < mazeGen.height;
+    const size_t groups = (count + LANES - 1) / LANES;
+    for (size_t g = 0; g < groups; ++g) {
+        uint8_t flags = groupFlags[g];
+        if (!flags) continue;
+        for (int lane = 0; lane < LANES; ++lane) {
+            size_t i = g * LANES + lane;
+            bool inRange = (flags >> lane) & 1u;
+            bool atTarget = (flags >> (LANES + lane)) & 1u;
+            if (i >= count || (!inRange && !atTarget)) continue;
+            ++scalarCount;
+
+            if (inRange) {
+                bool visible = false;
+                if (freezeTimer[i] <= 0.0f) {
+                    int cellX = static_cast<int>(posX[i] / cellSize), cellY = static_cast<int>(posY[i] / cellSize);
+                    bool culled = usePvs && pvs.InRange(cellX, cellY, playerCellX, playerCellY)
+                        && !pvs.CanSee(cellX, cellY, playerCellX, playerCellY);
+                    visible = !culled && HasLineOfSight(mazeGen.maze, cellSize, posX[i], posY[i], playerX, playerY);
+                }
+                chaseMask[i] = visible ? ~0u : 0u;
+            }
+            if (atTarget) ChooseWaypoint(i, playerCellX, playerCellY, mazeGen, cellSize, flowField);
+        }
+    }
+
+    // 3. SIMD: 朝路点移动
+    Integrate(deltaTime);
+}
+
+void MonsterSwarm::UpdateTimersAndDistances(float deltaTime, float playerX, float playerY) {
+    const size_t padded = groupFlags.size() * LANES;
+#if SWARM_USE_SSE
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 px = _mm_set1_ps(playerX);
+    const __m128 py = _mm_set1_ps(playerY);
+    for (size_t i = 0; i < padded; i += LANES) {
+        _mm_store_ps(&freezeTimer[i], _mm_max_ps(_mm_sub_ps(_mm_load_ps(&freezeTimer[i]), dt), zero));
+        _mm_store_ps(&turnTimer[i], _mm_sub_ps(_mm_load_ps(&turnTimer[i]), dt));
+
+        __m128 x = _mm_load_ps(&posX[i]);
+        __m128 y = _mm_load_ps(&posY[i]);
+        __m128 dx = _mm_sub_ps(px, x);
+        __m128 dy = _mm_sub_ps(py, y);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        _mm_store_ps(&distanceSq[i], d2);
+
+        __m128 inRange = _mm_cmplt_ps(d2, _mm_load_ps(&rangeSq[i]));
+        __m128 atTarget = _mm_and_ps(_mm_cmpeq_ps(x, _mm_load_ps(&targetX[i])), _mm_cmpeq_ps(y, _mm_load_ps(&targetY[i])));
+        // 离开探测范围即停止追逐
+        __m128i chase = _mm_load_si128(reinterpret_cast<const __m128i*>(&chaseMask[i]));
+        chase = _mm_and_si128(chase, _mm_castps_si128(inRange));
+        _mm_store_si128(reinterpret_cast<__m128i*>(&chaseMask[i]), chase);
+
+        groupFlags[i / LANES] = static_cast<uint8_t>(_mm_movemask_ps(inRange) | (_mm_movemask_ps(atTarget) << LANES));
+    }
+#else
+    for (size_t i = 0; i < padded; i += LANES) {
+        uint8_t flags = 0;
+        for (int lane = 0; lane < LANES; ++lane) {
+            size_t k = i + lane;
+            freezeTimer[k] = std::max(freezeTimer[k] - deltaTime, 0.0f);
+            turnTimer[k] -= deltaTime;
+            float dx = playerX - posX[k], dy = playerY - posY[k];
+            distanceSq[k] = dx * dx + dy * dy;
+            bool inRange = distanceSq[k] < rangeSq[k];
+            if (!inRange) chaseMask[k] = 0u;
+            if (inRange) flags |= 1u << lane;
+            if (posX[k] == targetX[k] && posY[k] == targetY[k]) flags |= 1u << (LANES + lane);
+        }
+        groupFlags[i / LANES] = flags;
+    }
+#endif
+}
+
+void MonsterSwarm::Integrate(float deltaTime) {
+    const size_t padded = groupFlags.size() * LANES;
+#if SWARM_USE_SSE
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    for (size_t i = 0; i < padded; i += LANES) {
+        __m128 chase = _mm_castsi128_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(&chaseMask[i])));
+        __m128 speed = _mm_or_ps(_mm_and_ps(chase, _mm_load_ps(&chaseSpeed[i])), _mm_andnot_ps(chase, _mm_load_ps(&baseSpeed[i])));
+        __m128 frozen = _mm_cmpgt_ps(_mm_load_ps(&freezeTimer[i]), zero);
+        __m128 step = _mm_mul_ps(_mm_andnot_ps(frozen, speed), dt);
+        __m128 negStep = _mm_xor_ps(step, signMask);
+
+        __m128 x = _mm_load_ps(&posX[i]);
+        __m128 y = _mm_load_ps(&posY[i]);
+        __m128 moveX = _mm_min_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(&targetX[i]), x), negStep), step);
+        __m128 moveY = _mm_min_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(&targetY[i]), y), negStep), step);
+        _mm_store_ps(&posX[i], _mm_add_ps(x, moveX));
+        _mm_store_ps(&posY[i], _mm_add_ps(y, moveY));
+    }
+#else
+    for (size_t i = 0; i < padded; ++i) {
+        float speed = chaseMask[i] ? chaseSpeed[i] : baseSpeed[i];
+        float step = freezeTimer[i] > 0.0f ? 0.0f : speed * deltaTime;
+        posX[i] += std::clamp(targetX[i] - posX[i], -step, step);
+        posY[i] += std::clamp(targetY[i] - posY[i], -step, step);
+    }
+#endif
+}
+
+// 到达路点 (格子中心) 后选择下一个路点: 追逐时走向玩家的下一格，巡逻时沿当前方向前进，
+// 受阻或转向计时到期时随机换一个相通的方向 (尽量不掉头)
+void MonsterSwarm::ChooseWaypoint(size_t i, int playerCellX, int playerCellY, const MazeGenerator& mazeGen, float cellSize, const FlowField* flowField) {
+    const int width = mazeGen.width, height = mazeGen.height;
+    int cellX = std::clamp(static_cast<int>(posX[i] / cellSize), 0, width - 1);
+    int cellY = std::clamp(static_cast<int>(posY[i] / cellSize), 0, height - 1);
+    const MazeGrid& grid = mazeGen.maze;
+
+    if (chaseMask[i]) {
+        bool haveRoute = true;
+        int next = -1;
+        if (flowField && flowField->IsValid(width, height)) {
+            next = flowField->NextCell(cellX, cellY);
+        }
+        else if (mazeGen.tree.IsBuilt(width, height) && playerCellX >= 0 && playerCellX < width && playerCellY >= 0 && playerCellY < height) {
+            next = mazeGen.tree.NextStep(mazeGen.tree.CellIndex(cellX, cellY), mazeGen.tree.CellIndex(playerCellX, playerCellY));
+        }
+        else {
+            haveRoute = false; // 没有流场和生成树: 退回巡逻
+        }
+        if (haveRoute) {
+            // 已在玩家所在格时原地等待
+            if (next >= 0 && next != cellY * width + cellX) {
+                targetX[i] = (next % width + 0.5f) * cellSize;
+                targetY[i] = (next / width + 0.5f) * cellSize;
+            }
+            return;
+        }
+    }
+
+    int dir = direction[i];
+    if (dir < 0 || turnTimer[i] <= 0.0f || grid.HasWall(cellX, cellY, dir)) {
+        int options[4], optionCount = 0;
+        for (int d = 0; d < 4; ++d) {
+            if (!grid.HasWall(cellX, cellY, d) && (dir < 0 || d != ((dir + 2) & 3))) options[optionCount++] = d;
+        }
+        if (optionCount == 0 && dir >= 0 && !grid.HasWall(cellX, cellY, (dir + 2) & 3)) options[optionCount++] = (dir + 2) & 3; // 死胡同: 掉头
+        dir = optionCount > 0 ? options[NextRandom() % optionCount] : -1;
+        direction[i] = static_cast<int8_t>(dir);
+        turnTimer[i] = 0.5f + (NextRandom() % 1024) * (1.5f / 1024.0f); // 0.5 ~ 2 秒，与 Monster 的转向间隔一致
+    }
+    if (dir >= 0) {
+        targetX[i] = (cellX + DX[dir] + 0.5f) * cellSize;
+        targetY[i] = (cellY + DY[dir] + 0.5f) * cellSize;
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include "MazeGenerator.h"
+#include "FlowField.h"
+
+// 按 Alignment 字节对齐分配的分配器 (SIMD 整组加载/存储用)
+template <typename T, size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U> bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+// 结构数组 (SoA) 形式的怪物群
+// 每个属性单独存放在 16 字节对齐的数组中，长度补齐到 LANES 的倍数，
+// 每帧的距离/探测范围/冻结计时/移动积分按 LANES 个怪物一组用 SSE 计算。
+// 怪物只在相邻且相通的格子中心之间移动 (路点)，因此不需要逐帧的墙体碰撞检测；
+// 只有到达路点、或玩家在探测范围内需要做视线检测的怪物才进入逐个处理的标量路径。
+// 行为与 Monster 一致: 看到玩家时沿流场/生成树追逐，否则沿走廊巡逻并不时随机转向。
+class MonsterSwarm {
+public:
+    static const int LANES = 4; // 每组怪物数 (SSE 单精度宽度)
+
+    template <typename T>
+    using Array = std::vector<T, AlignedAllocator<T, 16>>;
+
+    // --- 各属性数组 (下标 < Size() 有效) ---
+    Array<float> posX, posY;       // 位置 (像素)
+    Array<float> targetX, targetY; // 当前路点 (格子中心)
+    Array<float> baseSpeed;        // 巡逻速度
+    Array<float> chaseSpeed;       // 追逐速度
+    Array<float> rangeSq;          // 探测范围的平方
+    Array<float> freezeTimer;      // 剩余冻结时间 (> 0 即冻结)
+    Array<float> turnTimer;        // 巡逻时距离下次随机转向的时间
+    Array<float> distanceSq;       // 本帧到玩家距离的平方 (Update 计算)
+    Array<uint32_t> chaseMask;     // 追逐中为全 1，否则为 0
+    Array<int8_t> direction;       // 巡逻方向 (WALL_TOP..WALL_LEFT)，-1 表示无
+
+    explicit MonsterSwarm(unsigned int seed = 1u) : rngState(seed ? seed : 1u) {}
+
+    size_t Size() const { return count; }
+
+    void Clear();
+
+    // 在格子 (cellX, cellY) 中心加入一个怪物
+    void Add(int cellX, int cellY, float cellSize, float patrolSpeed = 50.0f, float chasingSpeed = 150.0f, float detectionRange = 200.0f);
+
+    // 冻结所有怪物 seconds 秒
+    void FreezeAll(float seconds);
+
+    bool IsChasing(size_t i) const { return chaseMask[i] != 0; }
+    bool IsFrozen(size_t i) const { return freezeTimer[i] > 0.0f; }
+
+    // 更新全部怪物; flowField 为朝向玩家的共享流场 (可为空，此时用生成树，二者都没有则只巡逻)
+    void Update(float deltaTime, float playerX, float playerY, int playerCellX, int playerCellY,
+                const MazeGenerator& mazeGen, float cellSize, const FlowField* flowField);
+
+    // 上一次 Update 中走标量路径的怪物数
+    size_t LastScalarCount() const { return scalarCount; }
+
+private:
+    size_t count = 0;
+    size_t scalarCount = 0;
+    uint32_t rngState;
+    std::vector<uint8_t> groupFlags; // 每组: 低 4 位 = 在探测范围内, 高 4 位 = 已到达路点
+
+    uint32_t NextRandom() {
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 17;
+        rngState ^= rngState << 5;
+        return rngState;
+    }
+
+    void UpdateTimersAndDistances(float deltaTime, float playerX, float playerY);
+    void Integrate(float deltaTime);
+    void ChooseWaypoint(size_t i, int playerCellX, int playerCellY, const MazeGenerator& mazeGen, float cellSize, const FlowField* flowField);
+};
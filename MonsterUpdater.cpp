@@ -0,0 +1,87 @@
+#include "MonsterUpdater.h"
+#include "Player.h"
+#include <algorithm>
+#include <chrono>
+
+void MonsterUpdater::Update(std::vector<Monster>& monsters, float deltaTime, const Player& player, const MazeGenerator& mazeGen,
+                            float cellSize, const FlowField* flowField, bool releaseFrozen) {
+    threadEvents.resize(jobs.ThreadCount());
+    for (auto& buffer : threadEvents) buffer.clear();
+
+    jobs.ParallelFor(monsters.size(), GRAIN_SIZE, [&](size_t begin, size_t end, int threadIndex) {
+        std::vector<MonsterEvent>& out = threadEvents[threadIndex];
+        for (size_t i = begin; i < end; ++i) {
+            Monster& monster = monsters[i];
+            monster.Update(deltaTime, player, mazeGen, cellSize, flowField);
+            CollectEvents(monster, static_cast<uint32_t>(i), player, releaseFrozen, out);
+        }
+    });
+    MergeEvents();
+}
+
+void MonsterUpdater::Update(std::vector<Monster>& monsters, AiLodScheduler& scheduler, const Player& player, const MazeGenerator& mazeGen,
+                            float cellSize, const FlowField* flowField, bool releaseFrozen) {
+    threadEvents.resize(jobs.ThreadCount());
+    for (auto& buffer : threadEvents) buffer.clear();
+    threadCost.assign(static_cast<size_t>(jobs.ThreadCount()) * 2, 0.0);
+
+    const std::vector<AiLodScheduler::Task>& tasks = scheduler.Tasks();
+    const float maxStep = std::max(scheduler.Settings().maxStep, 1e-3f);
+    jobs.ParallelFor(tasks.size(), GRAIN_SIZE, [&](size_t begin, size_t end, int threadIndex) {
+        std::vector<MonsterEvent>& out = threadEvents[threadIndex];
+        double* cost = &threadCost[static_cast<size_t>(threadIndex) * 2];
+        for (size_t t = begin; t < end; ++t) {
+            const AiLodScheduler::Task& task = tasks[t];
+            Monster& monster = monsters[task.monster];
+            // 近处任务不计时 (不受预算限制)
+            const bool timed = task.tier != AiLodScheduler::TIER_NEAR;
+            auto start = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+            if (task.tier == AiLodScheduler::TIER_FAR) {
+                monster.UpdateCoarse(task.deltaTime, mazeGen, cellSize);
+            }
+            else {
+                // 近处通常只有一帧的时间；中距离 (或刚从中距离进入近处) 时带着累计时间，分步补上
+                for (float remaining = task.deltaTime; remaining > 0.0f; remaining -= maxStep) {
+                    monster.Update(std::min(remaining, maxStep), player, mazeGen, cellSize, flowField);
+                }
+            }
+            CollectEvents(monster, task.monster, player, releaseFrozen, out);
+            if (timed) {
+                cost[task.tier == AiLodScheduler::TIER_MID ? 0 : 1] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+        }
+    });
+
+    // 本帧没轮到的怪物也要解除冻结 (它们离玩家很远，不会产生事件)
+    if (releaseFrozen) {
+        for (auto& monster : monsters) monster.frozen = false;
+    }
+
+    double midSeconds = 0.0, farSeconds = 0.0;
+    for (size_t i = 0; i < threadCost.size(); i += 2) {
+        midSeconds += threadCost[i];
+        farSeconds += threadCost[i + 1];
+    }
+    scheduler.ReportCost(midSeconds, farSeconds);
+    MergeEvents();
+}
+
+void MonsterUpdater::CollectEvents(Monster& monster, uint32_t index, const Player& player, bool releaseFrozen, std::vector<MonsterEvent>& out) {
+    float distance = glm::distance(monster.position, player.position);
+    if (monster.visible && distance < monster.detectionRange) {
+        out.push_back({ index, MonsterEvent::ALERT });
+    }
+    if (releaseFrozen) monster.frozen = false;
+    if (!monster.frozen && distance < player.radius + monster.radius) { // 冻结状态下不造成伤害
+        out.push_back({ index, MonsterEvent::CONTACT });
+    }
+}
+
+void MonsterUpdater::MergeEvents() {
+    // 确定性合并: 不依赖哪个线程执行了哪一块
+    events.clear();
+    for (const auto& buffer : threadEvents) events.insert(events.end(), buffer.begin(), buffer.end());
+    std::sort(events.begin(), events.end(), [](const MonsterEvent& a, const MonsterEvent& b) {
+        return a.monster != b.monster ? a.monster < b.monster : a.type < b.type;
+    });
+}
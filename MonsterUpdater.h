@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "Monster.h"
+#include "JobSystem.h"
+#include "AiLodScheduler.h"
+
+class Player;
+
+// 怪物更新中产生的副作用 (播放音效、伤害玩家等)，由主线程在并行阶段结束后统一处理
+struct MonsterEvent {
+    enum Type : uint8_t {
+        ALERT,   // 怪物可见且玩家在探测范围内 (警报音效)
+        CONTACT  // 未冻结的怪物碰到了玩家
+    };
+    uint32_t monster; // 怪物下标
+    Type type;
+};
+
+// 在 JobSystem 上分块并行更新 std::vector<Monster>
+// 每个怪物的 Update 只读玩家与迷宫、只写自己，因此各块之间互不干扰；
+// 副作用先写入执行线程私有的事件缓冲区，并行阶段结束后按 (怪物下标, 类型) 排序合并，
+// 结果与线程数和任务调度顺序无关。
+class MonsterUpdater {
+public:
+    static const size_t GRAIN_SIZE = 64; // 每个任务块的怪物数 (怪物很少时直接在主线程上更新)
+
+    explicit MonsterUpdater(JobSystem& jobSystem) : jobs(jobSystem) {}
+
+    // releaseFrozen 为 true 时顺便解除冻结 (Q 技能的冻结时间已到)
+    void Update(std::vector<Monster>& monsters, float deltaTime, const Player& player, const MazeGenerator& mazeGen,
+                float cellSize, const FlowField* flowField, bool releaseFrozen);
+
+    // 只执行 AI LOD 调度器本帧给出的任务 (先调用 scheduler.Schedule):
+    // 近处完整更新；中距离把累计的时间按 maxStep 分步补上；远处做格子级粗略巡逻。
+    // 中距离/远处任务的实测耗时回报给调度器；未被调度的怪物只处理冻结解除。
+    void Update(std::vector<Monster>& monsters, AiLodScheduler& scheduler, const Player& player, const MazeGenerator& mazeGen,
+                float cellSize, const FlowField* flowField, bool releaseFrozen);
+
+    // 上一次 Update 产生的事件，按怪物下标排序
+    const std::vector<MonsterEvent>& Events() const { return events; }
+
+private:
+    JobSystem& jobs;
+    std::vector<std::vector<MonsterEvent>> threadEvents; // 每个线程一个缓冲区 (跨帧复用)
+    std::vector<MonsterEvent> events;
+    std::vector<double> threadCost; // 每个线程本帧中距离/远处任务的耗时 (秒)，每线程两项
+
+    // 检查一个刚更新过的怪物是否触发警报或碰到玩家
+    static void CollectEvents(Monster& monster, uint32_t index, const Player& player, bool releaseFrozen, std::vector<MonsterEvent>& out);
+
+    // 合并各线程的事件缓冲区并按 (怪物下标, 类型) 排序
+    void MergeEvents();
+};
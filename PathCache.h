@@ -0,0 +1,113 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// 所有怪物共用的路径缓存 (LRU，有界)
+// 以 (起点格, 终点格) 为键保存逐格路径。最短路径的后缀仍是最短路径，所以缓存按 (格子, 终点) 为路径上的
+// 每一格建立索引: 查询的起点只要落在某条通往同一终点的缓存路径上，就直接取出从该格开始的尾段。
+// 每条路径记下迷宫纪元 (MazeGenerator::epoch)，迷宫重新生成或加载后纪元改变，第一次访问时整个缓存被清空。
+// 条目数和路径格子总数都有上限，超出时淘汰最久未使用的路径。
+class PathCache {
+public:
+    struct Stats {
+        size_t hits = 0;          // 起点与缓存路径的起点相同
+        size_t suffixHits = 0;    // 起点落在缓存路径中间，复用尾段
+        size_t misses = 0;
+        size_t evictions = 0;     // 因容量淘汰的路径数
+        size_t invalidations = 0; // 因迷宫纪元改变而清空的次数
+    };
+
+    explicit PathCache(size_t maxEntries = 512, size_t maxCells = 1u << 18) : maxEntries(maxEntries), maxCells(maxCells) {}
+
+    // 查找从 source 到 goal 的路径 (含两端)，命中时写入 outPath 并返回 true
+    bool Lookup(uint32_t epoch, int source, int goal, std::vector<int>& outPath) {
+        SyncEpoch(epoch);
+        auto found = index.find(Key(source, goal));
+        if (found == index.end()) {
+            ++stats.misses;
+            return false;
+        }
+        const Position& position = found->second;
+        const std::vector<int>& cells = position.entry->cells;
+        outPath.assign(cells.begin() + position.offset, cells.end());
+        if (position.offset == 0) ++stats.hits;
+        else ++stats.suffixHits;
+        lru.splice(lru.begin(), lru, position.entry);
+        return true;
+    }
+
+    // 保存一条从 cells.front() 到 cells.back() 的逐格路径
+    void Insert(uint32_t epoch, const std::vector<int>& cells) {
+        SyncEpoch(epoch);
+        if (cells.empty() || cells.size() > maxCells || maxEntries == 0) return;
+        const int goal = cells.back();
+        auto existing = index.find(Key(cells.front(), goal));
+        if (existing != index.end() && existing->second.offset == 0) { // 已经缓存过同样的路径
+            lru.splice(lru.begin(), lru, existing->second.entry);
+            return;
+        }
+
+        lru.push_front(Entry{ goal, cells });
+        cachedCells += cells.size();
+        // 较新的路径覆盖旧路径在同一格上的索引 (两者的尾段相同)
+        for (size_t i = 0; i < cells.size(); ++i) index[Key(cells[i], goal)] = Position{ lru.begin(), static_cast<uint32_t>(i) };
+        while (lru.size() > maxEntries || cachedCells > maxCells) {
+            Evict();
+            ++stats.evictions;
+        }
+    }
+
+    void Clear() {
+        lru.clear();
+        index.clear();
+        cachedCells = 0;
+    }
+
+    size_t EntryCount() const { return lru.size(); }
+    size_t CellCount() const { return cachedCells; }
+    const Stats& GetStats() const { return stats; }
+    void ResetStats() { stats = Stats(); }
+
+private:
+    struct Entry {
+        int goal;
+        std::vector<int> cells;
+    };
+    struct Position {
+        std::list<Entry>::iterator entry;
+        uint32_t offset; // 格子在路径中的下标
+    };
+
+    static uint64_t Key(int cell, int goal) {
+        return static_cast<uint64_t>(static_cast<uint32_t>(goal)) << 32 | static_cast<uint32_t>(cell);
+    }
+
+    void SyncEpoch(uint32_t current) {
+        if (current == epoch) return;
+        if (!lru.empty()) ++stats.invalidations;
+        Clear();
+        epoch = current;
+    }
+
+    // 淘汰最久未使用的路径，只删除仍指向它的索引
+    void Evict() {
+        auto victim = std::prev(lru.end());
+        for (int cell : victim->cells) {
+            auto found = index.find(Key(cell, victim->goal));
+            if (found != index.end() && found->second.entry == victim) index.erase(found);
+        }
+        cachedCells -= victim->cells.size();
+        lru.erase(victim);
+    }
+
+    size_t maxEntries;
+    size_t maxCells;
+    std::list<Entry> lru; // 队首最近使用
+    std::unordered_map<uint64_t, Position> index; // (格子, 终点) -> 经过该格的缓存路径
+    size_t cachedCells = 0;
+    uint32_t epoch = 0;
+    Stats stats;
+};
@@ -0,0 +1,246 @@
+#include "PathService.h"
+#include <chrono>
+#include <algorithm>
+
+uint32_t PathService::Submit(uint32_t requester, int startCell, int goalCell) {
+    ++stats.submitted;
+    auto existing = tickets.find(requester);
+    if (existing != tickets.end()) {
+        if (existing->second.goal == goalCell) {
+            ++stats.duplicates;
+            return existing->second.ticket;
+        }
+        RemoveRequest(requester, existing->second);
+        tickets.erase(existing);
+        ++stats.cancelled;
+    }
+
+    uint32_t ticket = nextTicket++;
+    if (nextTicket == 0) nextTicket = 1;
+    tickets[requester] = Ticket{ ticket, goalCell };
+    if (cache) unchecked.push_back({ requester, ticket, startCell });
+    auto group = groupByGoal.find(goalCell);
+    if (group != groupByGoal.end()) {
+        ++stats.coalesced;
+        group->second->requests.push_back({ requester, ticket, startCell });
+    }
+    else {
+        groups.push_back(Group{ goalCell, { { requester, ticket, startCell } } });
+        groupByGoal[goalCell] = std::prev(groups.end());
+    }
+    return ticket;
+}
+
+void PathService::Cancel(uint32_t requester) {
+    auto existing = tickets.find(requester);
+    if (existing == tickets.end()) return;
+    RemoveRequest(requester, existing->second);
+    tickets.erase(existing);
+    ++stats.cancelled;
+}
+
+void PathService::Reset() {
+    stats.cancelled += tickets.size();
+    groups.clear();
+    groupByGoal.clear();
+    tickets.clear();
+    results.clear();
+    unchecked.clear();
+    searching = false;
+    tracing = false;
+}
+
+void PathService::RemoveRequest(uint32_t requester, const Ticket& ticket) {
+    auto group = groupByGoal.find(ticket.goal);
+    if (group == groupByGoal.end()) return;
+    std::vector<Request>& requests = group->second->requests;
+    requests.erase(std::remove_if(requests.begin(), requests.end(), [&](const Request& r) { return r.requester == requester; }), requests.end());
+    // 空组留在队列里，轮到时直接丢弃 (可能是进行中的搜索)
+}
+
+void PathService::Deliver(const Request& request, bool waypoints, const std::vector<int>& cells) {
+    if (cache && !waypoints && !cells.empty()) cache->Insert(mazeEpoch, cells);
+    results.push_back(PathResult{ request.requester, request.ticket, waypoints, cells });
+    tickets.erase(request.requester);
+    ++stats.completed;
+}
+
+void PathService::Service(const MazeGenerator& mazeGen, double budgetSeconds) {
+    const auto start = std::chrono::steady_clock::now();
+    results.clear(); // 释放上一帧的结果也计入时间片
+    mazeEpoch = mazeGen.epoch;
+    if (cache) {
+        // 先交付缓存命中的新请求，不必等前面的组搜索完
+        for (const Request& request : unchecked) {
+            auto ticket = tickets.find(request.requester);
+            if (ticket == tickets.end() || ticket->second.ticket != request.ticket) continue; // 已取消或被新请求取代
+            if (!cache->Lookup(mazeEpoch, request.start, ticket->second.goal, scratch)) continue;
+            RemoveRequest(request.requester, ticket->second);
+            ++stats.cached;
+            results.push_back(PathResult{ request.requester, request.ticket, false, scratch });
+            tickets.erase(ticket);
+            ++stats.completed;
+        }
+        unchecked.clear();
+    }
+    auto outOfTime = [&]() {
+        return budgetSeconds > 0.0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= budgetSeconds;
+    };
+    // 先做完上一帧没回溯完的路径 (它用的是队首组的 BFS 树，在此之前不能开始新的搜索)
+    if (tracing && !ContinueTrace(outOfTime)) return;
+    const size_t cellCount = static_cast<size_t>(mazeGen.width) * mazeGen.height;
+
+    while (!groups.empty()) {
+        Group& group = groups.front();
+        if (group.requests.empty()) {
+            // 组里的请求都已取消
+            if (searching && searchGoal == group.goal) searching = false;
+            groupByGoal.erase(group.goal);
+            groups.pop_front();
+            continue;
+        }
+        if (!searching) {
+            if (group.goal < 0 || static_cast<size_t>(group.goal) >= cellCount) {
+                for (const Request& request : group.requests) Deliver(request, false, {});
+                group.requests.clear();
+                continue;
+            }
+            if (group.requests.size() == 1 && SearchSingle(mazeGen, group)) {
+                group.requests.clear();
+                if (outOfTime()) break;
+                continue;
+            }
+            StartSearch(mazeGen, group.goal);
+        }
+
+        // 推进 BFS，每展开一批格子检查一次时间和组内的起点
+        const int width = searchWidth;
+        static const int DX[4] = { 0, 1, 0, -1 };
+        static const int DY[4] = { -1, 0, 1, 0 };
+        bool paused = false;
+        while (!group.requests.empty()) {
+            // 一批起点可能同时被访问到，逐条回溯路径也计入时间片
+            if (!DeliverReached(group, outOfTime)) {
+                paused = true;
+                break;
+            }
+            if (group.requests.empty()) break;
+            if (head >= queue.size()) {
+                for (const Request& request : group.requests) Deliver(request, false, {}); // 不可达
+                group.requests.clear();
+                break;
+            }
+            if (outOfTime()) {
+                paused = true;
+                break;
+            }
+            for (size_t end = std::min(queue.size(), head + 256); head < end; ++head) {
+                uint32_t cell = queue[head];
+                int x = static_cast<int>(cell % width), y = static_cast<int>(cell / width);
+                for (int dir = 0; dir < 4; ++dir) {
+                    if (mazeGen.maze.HasWall(x, y, dir)) continue;
+                    uint32_t next = static_cast<uint32_t>((y + DY[dir]) * width + (x + DX[dir]));
+                    if (stamp[next] == generation) continue;
+                    stamp[next] = generation;
+                    parent[next] = cell;
+                    queue.push_back(next);
+                }
+            }
+        }
+        if (paused) break;
+        searching = false;
+        if (outOfTime()) break;
+    }
+}
+
+bool PathService::SearchSingle(const MazeGenerator& mazeGen, const Group& group) {
+    const Request& request = group.requests.front();
+    const int width = mazeGen.width;
+    if (request.start < 0 || request.start >= width * mazeGen.height) {
+        Deliver(request, false, {});
+        return true;
+    }
+    const int sx = request.start % width, sy = request.start / width, gx = group.goal % width, gy = group.goal / width;
+    if (mazeGen.hierarchy.IsBuilt(mazeGen.width, mazeGen.height)) {
+        ++stats.searches;
+        if (hierarchicalPathfinder.FindPath(mazeGen.hierarchy, mazeGen.maze, sx, sy, gx, gy, scratch, SINGLE_SEARCH_MAX_EXPANDED)) {
+            Deliver(request, true, scratch);
+            return true;
+        }
+    }
+    else if (mazeGen.corridors.IsBuilt(mazeGen.width, mazeGen.height)) {
+        ++stats.searches;
+        if (corridorPathfinder.FindPath(mazeGen.corridors, width, sx, sy, gx, gy, scratch, SINGLE_SEARCH_MAX_EXPANDED)) {
+            Deliver(request, false, scratch);
+            return true;
+        }
+    }
+    return false; // 没有加速结构，或搜索超出展开上限 / 不可达: 交给可分帧的 BFS
+}
+
+void PathService::StartSearch(const MazeGenerator& mazeGen, int goal) {
+    ++stats.searches;
+    searching = true;
+    searchGoal = goal;
+    searchWidth = mazeGen.width;
+    const size_t cellCount = static_cast<size_t>(mazeGen.width) * mazeGen.height;
+    if (parent.size() < cellCount) {
+        parent.resize(cellCount);
+        stamp.resize(cellCount, 0);
+        queue.reserve(cellCount);
+    }
+    if (++generation == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0u);
+        generation = 1;
+    }
+    queue.clear();
+    head = 0;
+    stamp[goal] = generation;
+    parent[goal] = static_cast<uint32_t>(goal);
+    queue.push_back(static_cast<uint32_t>(goal));
+}
+
+bool PathService::DeliverReached(Group& group, const std::function<bool()>& outOfTime) {
+    const size_t cellCount = parent.size();
+    for (size_t i = 0; i < group.requests.size();) {
+        const Request request = group.requests[i];
+        const bool inside = request.start >= 0 && static_cast<size_t>(request.start) < cellCount;
+        if (inside && stamp[request.start] != generation) {
+            ++i;
+            continue;
+        }
+        group.requests[i] = group.requests.back();
+        group.requests.pop_back();
+        if (inside) {
+            // 起点已访问: 沿 parent 从起点走到终点，正好是起点 -> 终点的顺序
+            tracing = true;
+            traceRequest = request;
+            traceCell = static_cast<uint32_t>(request.start);
+            trace.clear();
+            if (!ContinueTrace(outOfTime)) return false;
+        }
+        else {
+            Deliver(request, false, {});
+        }
+        if (outOfTime()) return false;
+    }
+    return true;
+}
+
+bool PathService::ContinueTrace(const std::function<bool()>& outOfTime) {
+    const uint32_t goal = static_cast<uint32_t>(searchGoal);
+    for (;;) {
+        for (int step = 0; step < TRACE_CELLS_PER_CHECK; ++step) {
+            trace.push_back(static_cast<int>(traceCell));
+            if (traceCell == goal) {
+                tracing = false;
+                // 回溯期间请求可能已被取消或被新请求取代
+                auto ticket = tickets.find(traceRequest.requester);
+                if (ticket != tickets.end() && ticket->second.ticket == traceRequest.ticket) Deliver(traceRequest, false, trace);
+                return true;
+            }
+            traceCell = parent[traceCell];
+        }
+        if (outOfTime()) return false;
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include "MazeGenerator.h"
+#include "PathCache.h"
+
+// 一个寻路请求的结果
+struct PathResult {
+    uint32_t requester;     // 提交请求的调用方编号 (例如怪物下标)
+    uint32_t ticket;        // Submit 返回的编号
+    bool waypoints = false; // true: cells 为分层寻路的路点 (见 MazeHierarchy)；false: 逐格路径
+    std::vector<int> cells; // 格子编号 (含起点和终点)；为空表示不可达
+};
+
+// 寻路请求队列
+// 调用方 Submit (起点格, 终点格) 后立即返回，请求在之后若干帧的 Service 中完成，结果从 Results 取走。
+// Service 只在主线程上按时间片运行，超出预算就停下，剩余的工作留到下一帧继续，不会让发出请求的那一帧卡住。
+// 终点相同的请求合并为一组，用一次从终点出发的 BFS 同时服务 (BFS 可跨帧暂停与恢复)；
+// 组里只有一个请求且迷宫建立了分层寻路图或走廊图时，改用它们做一次较便宜的搜索 (不可分帧，所以限制展开的节点数，
+// 超出时仍交给 BFS)。BFS 找到起点后逐格回溯路径，长路径的回溯同样按时间片进行，可跨帧继续。
+// 同一调用方重复提交同一终点时沿用进行中的请求；提交新终点会取消旧请求。
+// 换关 (迷宫被替换) 时必须调用 Reset，取消所有进行中的请求。
+// 设置了路径缓存 (SetCache) 时，新请求先查缓存，命中的在下一次 Service 开始时直接交付；算出的逐格路径写回缓存。
+class PathService {
+public:
+    static constexpr size_t SINGLE_SEARCH_MAX_EXPANDED = 1024; // 单个请求的分层 / 走廊搜索最多展开的节点数
+
+    struct Stats {
+        size_t submitted = 0;  // Submit 次数
+        size_t duplicates = 0; // 与进行中的请求相同而直接沿用的次数
+        size_t coalesced = 0;  // 加入了已有终点组的请求数
+        size_t completed = 0;  // 已交付的结果数
+        size_t cancelled = 0;  // 被取消的请求数 (换新终点或 Reset)
+        size_t searches = 0;   // 实际执行的搜索次数 (一组算一次)
+        size_t cached = 0;     // 直接从路径缓存交付的请求数
+    };
+
+    // 提交请求，返回请求编号 (从 1 开始)；同一调用方之前的请求若终点不同则被取消
+    uint32_t Submit(uint32_t requester, int startCell, int goalCell);
+
+    // 取消某个调用方的请求 (没有时不做任何事)
+    void Cancel(uint32_t requester);
+
+    // 取消所有请求并丢弃进行中的搜索 (迷宫重置时调用)
+    void Reset();
+
+    // 在 budgetSeconds 内推进请求 (<= 0 表示全部完成为止)，本次完成的结果见 Results
+    void Service(const MazeGenerator& mazeGen, double budgetSeconds);
+
+    // 共用的路径缓存 (可为空)，由调用方持有
+    void SetCache(PathCache* pathCache) { cache = pathCache; }
+
+    // 上一次 Service 完成的结果
+    const std::vector<PathResult>& Results() const { return results; }
+
+    size_t PendingCount() const { return tickets.size(); }
+    const Stats& GetStats() const { return stats; }
+
+private:
+    struct Request {
+        uint32_t requester;
+        uint32_t ticket;
+        int start;
+    };
+    struct Group {
+        int goal;
+        std::vector<Request> requests;
+    };
+    struct Ticket {
+        uint32_t ticket;
+        int goal;
+    };
+
+    std::list<Group> groups;                          // 按提交顺序排队的终点组 (队首可能正在搜索)
+    std::unordered_map<int, std::list<Group>::iterator> groupByGoal;
+    std::unordered_map<uint32_t, Ticket> tickets;     // 调用方 -> 进行中的请求
+    std::vector<PathResult> results;
+    uint32_t nextTicket = 1;
+    Stats stats;
+    PathCache* cache = nullptr;
+    std::vector<Request> unchecked; // 上次 Service 之后提交、尚未查过缓存的请求
+    uint32_t mazeEpoch = 0;         // 本次 Service 的迷宫纪元
+
+    // 队首组的 BFS 状态 (跨帧保留)
+    bool searching = false;
+    int searchGoal = -1;
+    int searchWidth = 0;
+    std::vector<uint32_t> parent;   // 每格朝终点的下一格
+    std::vector<uint32_t> stamp;    // parent 有效的搜索编号
+    std::vector<uint32_t> queue;
+    size_t head = 0;
+    uint32_t generation = 0;
+
+    HierarchicalPathfinder hierarchicalPathfinder; // 单个请求时使用
+    CorridorPathfinder corridorPathfinder;
+    std::vector<int> scratch;
+
+    // 正在回溯的请求 (已从组中移出；回溯可跨帧，完成前不开始新的搜索)
+    bool tracing = false;
+    Request traceRequest{};
+    uint32_t traceCell = 0;
+    std::vector<int> trace;
+
+    static constexpr int TRACE_CELLS_PER_CHECK = 4096;         // 回溯时每走这么多格检查一次时间
+
+    void RemoveRequest(uint32_t requester, const Ticket& ticket);
+    void Deliver(const Request& request, bool waypoints, const std::vector<int>& cells);
+
+    // 单个请求的同步搜索 (分层寻路 / 走廊图)；没有可用的加速结构时返回 false，交给 BFS
+    bool SearchSingle(const MazeGenerator& mazeGen, const Group& group);
+
+    void StartSearch(const MazeGenerator& mazeGen, int goal);
+    // 交付组内起点已被 BFS 访问到的请求 (每交付一条检查一次时间)；时间片用完时提前返回 false
+    bool DeliverReached(Group& group, const std::function<bool()>& outOfTime);
+    // 继续回溯 traceRequest 的路径，完成后交付；时间片用完时返回 false，下一次 Service 接着回溯
+    bool ContinueTrace(const std::function<bool()>& outOfTime);
+};
@@ -1,5 +1,6 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include "Player.h"
+#include "ChunkedMaze.h"
 #include <cmath> // For sqrt
 
 // --- 修改后的构造函数实现 ---
@@ -58,7 +59,7 @@ bool Player::CheckWallCollision(const MazeGenerator& mazeGen, float newX, float
         return true;
     }
 
-    const Cell& currentCell = mazeGen.maze[gridY][gridX];
+    const MazeGrid& grid = mazeGen.maze;
 
     float cellLeft = gridX * cellSize;
     float cellRight = (gridX + 1) * cellSize;
@@ -70,10 +71,10 @@ bool Player::CheckWallCollision(const MazeGenerator& mazeGen, float newX, float
     float playerTop = newY - radius;
     float playerBottom = newY + radius;
 
-    if (currentCell.walls[3] && playerLeft < cellLeft) return true;
-    if (currentCell.walls[1] && playerRight > cellRight) return true;
-    if (currentCell.walls[0] && playerTop < cellTop) return true;
-    if (currentCell.walls[2] && playerBottom > cellBottom) return true;
+    if (grid.HasWall(gridX, gridY, WALL_LEFT) && playerLeft < cellLeft) return true;
+    if (grid.HasWall(gridX, gridY, WALL_RIGHT) && playerRight > cellRight) return true;
+    if (grid.HasWall(gridX, gridY, WALL_TOP) && playerTop < cellTop) return true;
+    if (grid.HasWall(gridX, gridY, WALL_BOTTOM) && playerBottom > cellBottom) return true;
 
     return false;
 }
@@ -87,27 +88,22 @@ bool Player::CanMoveTo(int newCellX, int newCellY, const MazeGenerator& mazeGen)
         return false;
     }
 
-    // 获取当前单元格
-    const Cell& currentCell = mazeGen.maze[cellY][cellX];
-    // 获取目标单元格
-    const Cell& targetCell = mazeGen.maze[newCellY][newCellX];
-
     // 计算移动方向
     int dx = newCellX - cellX;
     int dy = newCellY - cellY;
 
-    // 检查墙壁 (确保两个相邻单元格之间的墙都被打通)
+    // 检查墙壁 (相邻单元格共用同一堵墙，只需查询一次)
     if (dx == 1) { // 向右移动
-        return !currentCell.walls[1] && !targetCell.walls[3];
+        return !mazeGen.maze.HasWall(cellX, cellY, WALL_RIGHT);
     }
     else if (dx == -1) { // 向左移动
-        return !currentCell.walls[3] && !targetCell.walls[1];
+        return !mazeGen.maze.HasWall(cellX, cellY, WALL_LEFT);
     }
     else if (dy == 1) { // 向下移动
-        return !currentCell.walls[2] && !targetCell.walls[0];
+        return !mazeGen.maze.HasWall(cellX, cellY, WALL_BOTTOM);
     }
     else if (dy == -1) { // 向上移动
-        return !currentCell.walls[0] && !targetCell.walls[2];
+        return !mazeGen.maze.HasWall(cellX, cellY, WALL_TOP);
     }
 
     // 不是相邻单元格或者没有有效方向
@@ -124,16 +120,44 @@ void Player::TryMove(int dx, int dy, const MazeGenerator& mazeGen, float cellSiz
 
     // 检查是否可以移动到目标单元格
     if (CanMoveTo(newCellX, newCellY, mazeGen)) {
-        // 设置移动状态
-        isMoving = true;
-        cellX = newCellX; // 更新逻辑上的单元格坐标
-        cellY = newCellY;
-        // 设置目标像素位置为新单元格的中心
-        targetPosition = glm::vec2(cellX * cellSize + cellSize / 2.0f, cellY * cellSize + cellSize / 2.0f);
-        // 播放脚步声等音效可以在这里添加
+        StartMoveTo(newCellX, newCellY, cellSize);
     }
 }
 
+// --- 分块无限迷宫版本 (没有外边界，墙壁通过区块查询) ---
+
+bool Player::CanMoveTo(int newCellX, int newCellY, ChunkedMaze& world) const {
+    int dx = newCellX - cellX;
+    int dy = newCellY - cellY;
+
+    if (dx == 1) return !world.HasWall(cellX, cellY, WALL_RIGHT);
+    if (dx == -1) return !world.HasWall(cellX, cellY, WALL_LEFT);
+    if (dy == 1) return !world.HasWall(cellX, cellY, WALL_BOTTOM);
+    if (dy == -1) return !world.HasWall(cellX, cellY, WALL_TOP);
+    return false;
+}
+
+void Player::TryMove(int dx, int dy, ChunkedMaze& world, float cellSize) {
+    if (isMoving) return;
+
+    int newCellX = cellX + dx;
+    int newCellY = cellY + dy;
+    if (CanMoveTo(newCellX, newCellY, world)) {
+        StartMoveTo(newCellX, newCellY, cellSize);
+    }
+}
+
+// 开始向相邻单元格移动
+void Player::StartMoveTo(int newCellX, int newCellY, float cellSize) {
+    // 设置移动状态
+    isMoving = true;
+    cellX = newCellX; // 更新逻辑上的单元格坐标
+    cellY = newCellY;
+    // 设置目标像素位置为新单元格的中心
+    targetPosition = glm::vec2(cellX * cellSize + cellSize / 2.0f, cellY * cellSize + cellSize / 2.0f);
+    // 播放脚步声等音效可以在这里添加
+}
+
 // 执行移动动画
 void Player::PerformMovement(float deltaTime, float cellSize) {
     if (!isMoving) return;
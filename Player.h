@@ -3,6 +3,8 @@
 #include <glm/glm.hpp>
 #include "MazeGenerator.h" // 需要访问迷宫结构
 
+class ChunkedMaze; // 前向声明 (分块无限迷宫)
+
 // 玩家类
 class Player {
 public:
@@ -40,9 +42,17 @@ public:
     // 触发向指定方向的移动 (如果可能的话)
     void TryMove(int dx, int dy, const MazeGenerator& mazeGen, float cellSize);
 
+    // 分块无限迷宫中的移动 (坐标不受边界限制)
+    bool CanMoveTo(int newCellX, int newCellY, ChunkedMaze& world) const;
+    void TryMove(int dx, int dy, ChunkedMaze& world, float cellSize);
+
     // 执行移动动画
     void PerformMovement(float deltaTime, float cellSize);
 
     // --- 原有的精确墙体碰撞检测 (可能不再直接用于移动判断，但在某些情况如推拉物体时可能有用) ---
     bool CheckWallCollision(const MazeGenerator& mazeGen, float newX, float newY, float cellSize) const;
+
+private:
+    // 开始向相邻单元格移动 (更新单元格坐标与目标位置)
+    void StartMoveTo(int newCellX, int newCellY, float cellSize);
 };
\ No newline at end of file
@@ -0,0 +1,142 @@
+#pragma once
+#include <glad/glad.h>
+#include <vector>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+// 2D 图元批处理
+// DrawCircle / DrawSquare / DrawTriangle 等只把顶点 (x, y, r, g, b) 按提交顺序追加到一个 CPU 数组，
+// 连续提交的同类图元合并成一段 (run)；Flush 时按提交顺序把各段写入一个环形顶点缓冲，每段一次 draw call
+// (所有批处理图元共用默认着色器)。图元类型切换时才分段，所以先画的图元不会被后画的盖住 (画家顺序)。
+// 环形缓冲分成 REGION_COUNT 段，写入用 glMapBufferRange 的非同步映射 (GL_MAP_UNSYNCHRONIZED_BIT)，
+// 驱动不做隐式同步也不重新分配存储；每离开一段就插入一个 fence，重新写入该段之前等待 GPU 读完。
+// (上下文是 OpenGL 3.3，没有 glBufferStorage 的持久映射，所以每次 Flush 映射一次写入的范围。)
+class RenderBatch {
+public:
+    enum Primitive { TRIANGLES = 0, LINES = 1, PRIMITIVE_COUNT = 2 };
+
+    // 每帧统计 (由调用方累加、清零)
+    struct Stats {
+        size_t drawCalls = 0;
+        size_t vertices = 0;
+        size_t bytesUploaded = 0;
+    };
+
+    static constexpr int FLOATS_PER_VERTEX = 5;
+    static constexpr size_t VERTEX_BYTES = FLOATS_PER_VERTEX * sizeof(float);
+    static constexpr int REGION_COUNT = 3;
+
+    explicit RenderBatch(size_t regionBytes = 4u << 20)
+        : regionBytes(std::max<size_t>(regionBytes / VERTEX_BYTES, 6) * VERTEX_BYTES) {
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, this->regionBytes * REGION_COUNT, nullptr, GL_STREAM_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, VERTEX_BYTES, (void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, VERTEX_BYTES, (void*)(2 * sizeof(float)));
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    ~RenderBatch() {
+        for (GLsync& fence : fences) {
+            if (fence) glDeleteSync(fence);
+        }
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+    }
+
+    RenderBatch(const RenderBatch&) = delete;
+    RenderBatch& operator=(const RenderBatch&) = delete;
+
+    // 为 vertexCount 个顶点预留空间，返回写入位置 (在下一次 Reserve 或 Flush 之前有效)
+    float* Reserve(Primitive primitive, size_t vertexCount) {
+        if (runs.empty() || runs.back().primitive != primitive) runs.push_back(Run{ primitive, 0 });
+        runs.back().vertexCount += vertexCount;
+        size_t offset = vertices.size();
+        vertices.resize(offset + vertexCount * FLOATS_PER_VERTEX);
+        return vertices.data() + offset;
+    }
+
+    bool Empty() const {
+        return runs.empty();
+    }
+
+    // 上传并绘制所有待画的图元 (调用方须已绑定默认着色器)
+    void Flush(Stats& stats) {
+        if (Empty()) return;
+        static const GLenum MODES[PRIMITIVE_COUNT] = { GL_TRIANGLES, GL_LINES };
+        static const size_t VERTICES_PER_PRIMITIVE[PRIMITIVE_COUNT] = { 3, 2 };
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        size_t first = 0; // 本段第一个顶点在 vertices 中的下标
+        for (const Run& run : runs) {
+            const Primitive primitive = run.primitive;
+            const size_t vertexCount = run.vertexCount;
+            for (size_t done = 0; done < vertexCount;) {
+                // 当前段剩余的空间 (按整个图元取整)；放不下时换到下一段
+                size_t room = (regionBytes - cursor) / VERTEX_BYTES;
+                room -= room % VERTICES_PER_PRIMITIVE[primitive];
+                if (room == 0) {
+                    AdvanceRegion();
+                    continue;
+                }
+                const size_t count = std::min(room, vertexCount - done);
+                const size_t offset = region * regionBytes + cursor;
+                void* target = glMapBufferRange(GL_ARRAY_BUFFER, offset, count * VERTEX_BYTES,
+                    GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+                if (target) {
+                    std::memcpy(target, vertices.data() + (first + done) * FLOATS_PER_VERTEX, count * VERTEX_BYTES);
+                    glUnmapBuffer(GL_ARRAY_BUFFER);
+                    glDrawArrays(MODES[primitive], static_cast<GLint>(offset / VERTEX_BYTES), static_cast<GLsizei>(count));
+                    ++stats.drawCalls;
+                    stats.vertices += count;
+                    stats.bytesUploaded += count * VERTEX_BYTES;
+                }
+                cursor += count * VERTEX_BYTES;
+                done += count;
+            }
+            first += vertexCount;
+        }
+        vertices.clear();
+        runs.clear();
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    // 一帧结束: 下一帧从新的一段开始写
+    void EndFrame() {
+        if (cursor > 0) AdvanceRegion();
+    }
+
+private:
+    // 为当前段插入 fence，切到下一段并等待 GPU 读完该段
+    void AdvanceRegion() {
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        region = (region + 1) % REGION_COUNT;
+        cursor = 0;
+        if (fences[region]) {
+            while (glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull) == GL_TIMEOUT_EXPIRED) {}
+            glDeleteSync(fences[region]);
+            fences[region] = nullptr;
+        }
+    }
+
+    // 连续提交的同类图元
+    struct Run {
+        Primitive primitive;
+        size_t vertexCount;
+    };
+
+    unsigned int VAO = 0, VBO = 0;
+    const size_t regionBytes;
+    int region = 0;
+    size_t cursor = 0; // 当前段内已写入的字节数
+    GLsync fences[REGION_COUNT] = {};
+    std::vector<float> vertices; // 按提交顺序排列的所有顶点
+    std::vector<Run> runs;
+};
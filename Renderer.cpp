@@ -48,22 +48,21 @@ void Renderer::DrawMaze(const MazeGenerator& mazeGen, float cellSize) {
     std::vector<float> vertices;
     for (int y = 0; y < mazeGen.height; ++y) {
         for (int x = 0; x < mazeGen.width; ++x) {
-            const Cell& cell = mazeGen.maze[y][x];
             float x1 = x * cellSize;
             float x2 = (x + 1) * cellSize;
             float y1 = y * cellSize;
             float y2 = (y + 1) * cellSize;
 
-            if (cell.walls[0]) { // Top
+            if (mazeGen.maze.HasWall(x, y, WALL_TOP)) { // Top
                 vertices.insert(vertices.end(), { x1, y1, 0.8f, 0.8f, 0.8f, x2, y1, 0.8f, 0.8f, 0.8f });
             }
-            if (cell.walls[1]) { // Right
+            if (mazeGen.maze.HasWall(x, y, WALL_RIGHT)) { // Right
                 vertices.insert(vertices.end(), { x2, y1, 0.8f, 0.8f, 0.8f, x2, y2, 0.8f, 0.8f, 0.8f });
             }
-            if (cell.walls[2]) { // Bottom
+            if (mazeGen.maze.HasWall(x, y, WALL_BOTTOM)) { // Bottom
                 vertices.insert(vertices.end(), { x2, y2, 0.8f, 0.8f, 0.8f, x1, y2, 0.8f, 0.8f, 0.8f });
             }
-            if (cell.walls[3]) { // Left
+            if (mazeGen.maze.HasWall(x, y, WALL_LEFT)) { // Left
                 vertices.insert(vertices.end(), { x1, y2, 0.8f, 0.8f, 0.8f, x1, y1, 0.8f, 0.8f, 0.8f });
             }
         }
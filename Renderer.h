@@ -7,6 +7,9 @@
 #include <vector>
 #include "Shader.h"
 #include "MazeGenerator.h"
+#include "MazeMesh.h"
+#include "RenderBatch.h"
+#include "ChunkedMaze.h"
 #include "Player.h"
 #include "Monster.h"
 #include "Collectible.h"
@@ -16,80 +19,218 @@
 class Renderer {
 public:
 	Shader shader;// 着色器程序
-	unsigned int VAO, VBO; // 顶点数组对象和顶点缓冲对象
+	Shader instancedShader; // 实例化绘制的着色器 (单位图形 + 每实例的位置/大小/颜色)
+	Shader shapeShader;     // 有向距离场图形: 每个圆/方形/三角形是一个实例化的四边形，形状在片段着色器中求值并抗锯齿
+	Shader mazeShader;      // 墙壁纹理模式的迷宫: 一个覆盖整座迷宫的四边形，逐像素查墙壁位掩码
+	RenderBatch batch; // 分块迷宫的线段与 (关闭距离场时的) 圆/方形/三角形先攒在这里，按图元类型合并成少数几次 draw call
 	glm::mat4 projection; // 投影矩阵
 
-	// 构造函数，初始化渲染器
-    Renderer(int screenWidth, int screenHeight) : shader("assets/shaders/vertex.glsl", "assets/shaders/fragment.glsl") {
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
+	// 迷宫墙壁网格常驻显存，只在迷宫纪元 (MazeGenerator::epoch) 或格子大小改变时重建
+	unsigned int mazeVAO, mazeVBO;
+	GLsizei mazeVertexCount = 0;
+	uint32_t mazeEpoch = 0;      // 0 表示尚未建立 (纪元从 1 开始)
+	float mazeCellSize = 0.0f;
 
-        projection = glm::ortho(0.0f, static_cast<float>(screenWidth), static_cast<float>(screenHeight), 0.0f, -1.0f, 1.0f);
+	// 迷宫的绘制方式: 线段网格的顶点数与格子数成正比，大迷宫改用墙壁纹理 (每格一个 R8UI 纹素，见 BuildMazeWallMasks)，
+	// 开销只与屏幕上的像素数有关。AUTO 在格子数达到 MAZE_TEXTURE_MIN_CELLS 时使用纹理 (超出最大纹理尺寸时仍用线段)
+	enum MazeRenderMode { MAZE_RENDER_AUTO, MAZE_RENDER_LINES, MAZE_RENDER_TEXTURE };
+	MazeRenderMode mazeRenderMode = MAZE_RENDER_AUTO;
+	static constexpr long long MAZE_TEXTURE_MIN_CELLS = 256 * 256;
+	unsigned int mazeTexture, mazeQuadVAO, mazeQuadVBO;
+	uint32_t mazeTextureEpoch = 0;
+	int mazeTextureWidth = 0, mazeTextureHeight = 0;
+	int maxTextureSize = 0;
+	std::vector<uint8_t> mazeMasks;       // 纹理中当前的内容 (用于找出需要更新的矩形)
+	std::vector<uint8_t> mazeMaskScratch;
+
+	// 实例化绘制的图形: 静态的单位网格 + 每帧重写的实例缓冲 (每实例 x, y, size, r, g, b [, 形状])
+	// 同一种实体无论多少个都只有一次 draw call
+	struct InstancedShape {
+		unsigned int VAO, meshVBO, EBO, instanceVBO;
+		GLsizei vertexCount; // 没有索引时为顶点数
+		GLsizei indexCount;  // 0 表示不用索引
+		int floatsPerInstance;
+	};
+	InstancedShape triangleShape; // 怪物
+	InstancedShape squareShape;   // 收集物
+	std::vector<float> instanceData; // 每帧复用的实例数据
 
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW); // Initial empty buffer
+	// 为 true 时 DrawCircle / DrawSquare / DrawTriangle (以及怪物、收集物) 走距离场路径:
+	// 每个图形只写 7 个浮点数，攒到 FlushBatch 时一次 draw call 画完；为 false 时回到三角形批处理与网格实例化
+	bool sdfShapes = true;
+	enum SdfShape { SDF_CIRCLE = 0, SDF_SQUARE = 1, SDF_TRIANGLE = 2 };
+	InstancedShape shapeQuad;            // [-1, 1] 的单位四边形
+	std::vector<float> shapeInstances;   // 每实例 x, y, size, r, g, b, 形状
 
+	RenderBatch::Stats frameStats;     // 本帧累计 (批处理、缓存的迷宫网格、实例化与距离场绘制)
+	RenderBatch::Stats lastFrameStats;
+
+	// 构造函数，初始化渲染器
+    Renderer(int screenWidth, int screenHeight)
+        : shader("assets/shaders/vertex.glsl", "assets/shaders/fragment.glsl"),
+          instancedShader("assets/shaders/instanced_vertex.glsl", "assets/shaders/fragment.glsl"),
+          shapeShader("assets/shaders/shape_vertex.glsl", "assets/shaders/shape_fragment.glsl"),
+          mazeShader("assets/shaders/maze_vertex.glsl", "assets/shaders/maze_fragment.glsl") {
+        projection = glm::ortho(0.0f, static_cast<float>(screenWidth), static_cast<float>(screenHeight), 0.0f, -1.0f, 1.0f);
+
+        glGenVertexArrays(1, &mazeVAO);
+        glGenBuffers(1, &mazeVBO);
+        glBindVertexArray(mazeVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, mazeVBO);
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
         glEnableVertexAttribArray(1);
         glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(2 * sizeof(float)));
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
 
+        // 与 DrawTriangle / DrawSquare 相同的形状，边长按 size = 1 缩放
+        const float triangle[] = { 0.0f, 0.8f, -0.7f, -0.4f, 0.7f, -0.4f };
+        const float square[] = { -0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f };
+        const unsigned int squareIndices[] = { 0, 1, 2, 2, 3, 0 };
+        CreateInstancedShape(triangleShape, triangle, 3, nullptr, 0);
+        CreateInstancedShape(squareShape, square, 4, squareIndices, 6);
+        const float quad[] = { -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f };
+        CreateInstancedShape(shapeQuad, quad, 4, squareIndices, 6, 7);
+
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+        glGenTextures(1, &mazeTexture);
+        glBindTexture(GL_TEXTURE_2D, mazeTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // 整数纹理不能过滤
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        const float unitQuad[] = { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f };
+        glGenVertexArrays(1, &mazeQuadVAO);
+        glGenBuffers(1, &mazeQuadVBO);
+        glBindVertexArray(mazeQuadVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, mazeQuadVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(unitQuad), unitQuad, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindVertexArray(0);
+        mazeShader.use();
+        mazeShader.setInt("walls", 0);
+        mazeShader.setVec3("wallColor", glm::vec3(0.8f, 0.8f, 0.8f));
     }
 
 	// 析构函数，释放资源
     ~Renderer() {
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
+        glDeleteVertexArrays(1, &mazeVAO);
+        glDeleteBuffers(1, &mazeVBO);
+        glDeleteTextures(1, &mazeTexture);
+        glDeleteVertexArrays(1, &mazeQuadVAO);
+        glDeleteBuffers(1, &mazeQuadVBO);
+        for (InstancedShape* shape : { &triangleShape, &squareShape, &shapeQuad }) {
+            glDeleteVertexArrays(1, &shape->VAO);
+            glDeleteBuffers(1, &shape->meshVBO);
+            glDeleteBuffers(1, &shape->instanceVBO);
+            if (shape->indexCount > 0) glDeleteBuffers(1, &shape->EBO);
+        }
     }
 
 	// 开始渲染帧
     void BeginFrame() {
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
+        instancedShader.use();
+        instancedShader.setMat4("projection", projection);
+        shapeShader.use();
+        shapeShader.setMat4("projection", projection);
+        mazeShader.use();
+        mazeShader.setMat4("projection", projection);
         shader.use();
         shader.setMat4("projection", projection);
     }
 
 	// 结束渲染帧
     void EndFrame(GLFWwindow* window) {
+        FlushBatch();
+        batch.EndFrame();
+        lastFrameStats = frameStats;
+        frameStats = RenderBatch::Stats();
         glfwSwapBuffers(window);
     }
 
+	// 上一帧的 draw call 数、顶点数和上传的字节数
+    const RenderBatch::Stats& LastFrameStats() const { return lastFrameStats; }
+
 	// 绘制迷宫
+	// 墙壁线段 (见 MazeMesh.h) 在迷宫生成或加载后第一次绘制时上传一次，之后每帧只有一次 draw call；
+	// 墙壁纹理模式见 DrawMazeTexture
     void DrawMaze(const MazeGenerator& mazeGen, float cellSize) {
-        glBindVertexArray(VAO);
-        std::vector<float> vertices;
-        for (int y = 0; y < mazeGen.height; ++y) {
-            for (int x = 0; x < mazeGen.width; ++x) {
-                const Cell& cell = mazeGen.maze[y][x];
-                float x1 = x * cellSize;
-                float x2 = (x + 1) * cellSize;
-                float y1 = y * cellSize;
-                float y2 = (y + 1) * cellSize;
-
-                if (cell.walls[0]) { // Top
-                    vertices.insert(vertices.end(), { x1, y1, 0.8f, 0.8f, 0.8f, x2, y1, 0.8f, 0.8f, 0.8f });
+        bool fitsTexture = mazeGen.width <= maxTextureSize && mazeGen.height <= maxTextureSize;
+        bool useTexture = mazeRenderMode == MAZE_RENDER_TEXTURE
+            || (mazeRenderMode == MAZE_RENDER_AUTO && static_cast<long long>(mazeGen.width) * mazeGen.height >= MAZE_TEXTURE_MIN_CELLS);
+        if (useTexture && fitsTexture) {
+            DrawMazeTexture(mazeGen, cellSize);
+            return;
+        }
+        if (mazeGen.epoch != mazeEpoch || cellSize != mazeCellSize) {
+            std::vector<float> vertices;
+            BuildMazeWallLines(mazeGen.maze, cellSize, vertices);
+            glBindBuffer(GL_ARRAY_BUFFER, mazeVBO);
+            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            mazeVertexCount = static_cast<GLsizei>(vertices.size() / 5);
+            mazeEpoch = mazeGen.epoch;
+            mazeCellSize = cellSize;
+            frameStats.bytesUploaded += vertices.size() * sizeof(float);
+        }
+        FlushBatch(); // 保持与之前提交的图元的先后顺序
+        glBindVertexArray(mazeVAO);
+        glDrawArrays(GL_LINES, 0, mazeVertexCount);
+        glBindVertexArray(0);
+        ++frameStats.drawCalls;
+        frameStats.vertices += mazeVertexCount;
+    }
+
+	// 墙壁纹理模式: 迷宫改变后只用 glTexSubImage2D 上传掩码有变化的矩形，每帧一个四边形、一次 draw call
+    void DrawMazeTexture(const MazeGenerator& mazeGen, float cellSize) {
+        if (mazeGen.epoch != mazeTextureEpoch) UpdateMazeTexture(mazeGen.maze, mazeGen.epoch);
+        FlushBatch();
+        mazeShader.use();
+        mazeShader.setVec2("mazeExtent", glm::vec2(mazeGen.width * cellSize, mazeGen.height * cellSize));
+        mazeShader.setFloat("cellSize", cellSize);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, mazeTexture);
+        glBindVertexArray(mazeQuadVAO);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        shader.use();
+        ++frameStats.drawCalls;
+        frameStats.vertices += 4;
+    }
+
+	// 绘制分块无限迷宫中 [firstCellX, firstCellX + cols) x [firstCellY, firstCellY + rows) 的窗口
+	// 窗口左上角画在屏幕原点；每格只画上墙和左墙，窗口最右列/最下行补画右墙/下墙
+    void DrawMaze(ChunkedMaze& world, float cellSize, int firstCellX, int firstCellY, int cols, int rows) {
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                int x = firstCellX + col;
+                int y = firstCellY + row;
+                float x1 = col * cellSize;
+                float x2 = (col + 1) * cellSize;
+                float y1 = row * cellSize;
+                float y2 = (row + 1) * cellSize;
+
+                if (world.HasWall(x, y, WALL_TOP)) {
+                    AddLine(x1, y1, x2, y1, 0.8f, 0.8f, 0.8f);
                 }
-                if (cell.walls[1]) { // Right
-                    vertices.insert(vertices.end(), { x2, y1, 0.8f, 0.8f, 0.8f, x2, y2, 0.8f, 0.8f, 0.8f });
+                if (world.HasWall(x, y, WALL_LEFT)) {
+                    AddLine(x1, y2, x1, y1, 0.8f, 0.8f, 0.8f);
                 }
-                if (cell.walls[2]) { // Bottom
-                    vertices.insert(vertices.end(), { x2, y2, 0.8f, 0.8f, 0.8f, x1, y2, 0.8f, 0.8f, 0.8f });
+                if (col == cols - 1 && world.HasWall(x, y, WALL_RIGHT)) {
+                    AddLine(x2, y1, x2, y2, 0.8f, 0.8f, 0.8f);
                 }
-                if (cell.walls[3]) { // Left
-                    vertices.insert(vertices.end(), { x1, y2, 0.8f, 0.8f, 0.8f, x1, y1, 0.8f, 0.8f, 0.8f });
+                if (row == rows - 1 && world.HasWall(x, y, WALL_BOTTOM)) {
+                    AddLine(x2, y2, x1, y2, 0.8f, 0.8f, 0.8f);
                 }
             }
         }
-
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
-        glDrawArrays(GL_LINES, 0, vertices.size() / 5);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
     }
 
 	// 绘制玩家
@@ -97,26 +238,43 @@ public:
         DrawCircle(player.position.x, player.position.y, player.radius, 1.0f, 0.0f, 0.0f);
     }
 
-	// 绘制怪物
+	// 绘制怪物 (实例化，一次 draw call)
     void DrawMonsters(const std::vector<Monster>& monsters) {
+        if (sdfShapes) {
+            for (const auto& monster : monsters) {
+                if (monster.visible) AddShape(SDF_TRIANGLE, monster.position.x, monster.position.y, monster.radius, 0.0f, 0.0f, 1.0f);
+            }
+            return;
+        }
+        instanceData.clear();
         for (const auto& monster : monsters) {
             if (monster.visible) {
-                DrawTriangle(monster.position.x, monster.position.y, monster.radius, 0.0f, 0.0f, 1.0f);
+                instanceData.insert(instanceData.end(), { monster.position.x, monster.position.y, monster.radius, 0.0f, 0.0f, 1.0f });
             }
         }
+        DrawInstanced(triangleShape, instanceData, instancedShader);
     }
 
-	// 绘制收集物
+	// 绘制收集物 (实例化，一次 draw call)
     void DrawCollectibles(const std::vector<Collectible>& collectibles) {
+        if (sdfShapes) {
+            for (const auto& item : collectibles) {
+                if (!item.collected) AddShape(SDF_SQUARE, item.position.x, item.position.y, item.size / 2.0f, 1.0f, 0.0f, 1.0f);
+            }
+            return;
+        }
+        instanceData.clear();
         for (const auto& item : collectibles) {
             if (!item.collected) {
-                DrawSquare(item.position.x, item.position.y, item.size, 1.0f, 0.0f, 1.0f);
+                instanceData.insert(instanceData.end(), { item.position.x, item.position.y, item.size, 1.0f, 0.0f, 1.0f });
             }
         }
+        DrawInstanced(squareShape, instanceData, instancedShader);
     }
 
 	// 绘制警报闪烁效果
     void DrawAlertFlash() {
+        FlushBatch();
         // 简单的全屏红色清屏作为闪烁效果
         glClearColor(0.8f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
@@ -126,67 +284,199 @@ public:
 
 
 private:
-	// 绘制圆形
+	// 绘制圆形 (拆成 32 个三角形进入批处理)
     void DrawCircle(float cx, float cy, float r, float red, float green, float blue) {
-        glBindVertexArray(VAO);
-        std::vector<float> vertices;
+        if (sdfShapes) {
+            AddShape(SDF_CIRCLE, cx, cy, r, red, green, blue);
+            return;
+        }
         const int segments = 32;
-        vertices.insert(vertices.end(), { cx, cy, red, green, blue }); // Center point
-        for (int i = 0; i <= segments; ++i) {
+        float* vertex = Reserve(RenderBatch::TRIANGLES, segments * 3);
+        float prevX = cx + r, prevY = cy;
+        for (int i = 1; i <= segments; ++i) {
             float angle = i * 2.0f * static_cast<float>(M_PI) / segments;
             float x = cx + r * cos(angle);
             float y = cy + r * sin(angle);
-            vertices.insert(vertices.end(), { x, y, red, green, blue });
+            vertex = WriteVertex(vertex, cx, cy, red, green, blue);
+            vertex = WriteVertex(vertex, prevX, prevY, red, green, blue);
+            vertex = WriteVertex(vertex, x, y, red, green, blue);
+            prevX = x;
+            prevY = y;
         }
-
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
-        glDrawArrays(GL_TRIANGLE_FAN, 0, vertices.size() / 5);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
     }
 
-	// 绘制方形
+	// 绘制方形 (两个三角形)
     void DrawSquare(float cx, float cy, float size, float red, float green, float blue) {
-        glBindVertexArray(VAO);
         float half = size / 2.0f;
-        float vertices[] = {
-            cx - half, cy - half, red, green, blue,
-            cx + half, cy - half, red, green, blue,
-            cx + half, cy + half, red, green, blue,
-            cx - half, cy + half, red, green, blue
-        };
-        unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+        if (sdfShapes) {
+            AddShape(SDF_SQUARE, cx, cy, half, red, green, blue);
+            return;
+        }
+        float* vertex = Reserve(RenderBatch::TRIANGLES, 6);
+        vertex = WriteVertex(vertex, cx - half, cy - half, red, green, blue);
+        vertex = WriteVertex(vertex, cx + half, cy - half, red, green, blue);
+        vertex = WriteVertex(vertex, cx + half, cy + half, red, green, blue);
+        vertex = WriteVertex(vertex, cx + half, cy + half, red, green, blue);
+        vertex = WriteVertex(vertex, cx - half, cy + half, red, green, blue);
+        WriteVertex(vertex, cx - half, cy - half, red, green, blue);
+    }
 
-        unsigned int EBO;
-        glGenBuffers(1, &EBO);
+	// 绘制三角形
+    void DrawTriangle(float cx, float cy, float r, float red, float green, float blue) {
+        if (sdfShapes) {
+            AddShape(SDF_TRIANGLE, cx, cy, r, red, green, blue);
+            return;
+        }
+        float* vertex = Reserve(RenderBatch::TRIANGLES, 3);
+        vertex = WriteVertex(vertex, cx, cy + r * 0.8f, red, green, blue); // Top
+        vertex = WriteVertex(vertex, cx - r * 0.7f, cy - r * 0.4f, red, green, blue); // Bottom Left
+        WriteVertex(vertex, cx + r * 0.7f, cy - r * 0.4f, red, green, blue); // Bottom Right
+    }
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_DYNAMIC_DRAW);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+	// 绘制线段
+    void AddLine(float x1, float y1, float x2, float y2, float red, float green, float blue) {
+        float* vertex = Reserve(RenderBatch::LINES, 2);
+        vertex = WriteVertex(vertex, x1, y1, red, green, blue);
+        WriteVertex(vertex, x2, y2, red, green, blue);
+    }
 
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+	// 批处理与距离场图形是两条队列，同一时刻只让其中一条有待画的图元: 切换时先画出另一条，保持提交顺序
+    float* Reserve(RenderBatch::Primitive primitive, size_t vertexCount) {
+        if (!shapeInstances.empty()) FlushShapes();
+        return batch.Reserve(primitive, vertexCount);
+    }
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    static float* WriteVertex(float* vertex, float x, float y, float red, float green, float blue) {
+        vertex[0] = x;
+        vertex[1] = y;
+        vertex[2] = red;
+        vertex[3] = green;
+        vertex[4] = blue;
+        return vertex + RenderBatch::FLOATS_PER_VERTEX;
+    }
+
+	// 距离场图形: 圆的 size 为半径，方形为半边长，三角形与 DrawTriangle 相同 (顶点为 size 的 0.7 / 0.8 倍)
+    void AddShape(SdfShape shape, float cx, float cy, float size, float red, float green, float blue) {
+        if (!batch.Empty()) FlushVertices();
+        shapeInstances.insert(shapeInstances.end(), { cx, cy, size, red, green, blue, static_cast<float>(shape) });
+    }
+
+	// 画出批处理与距离场图形中攒下的图元 (在任何不经过批处理的绘制之前调用，保持先后顺序)
+	// 两条队列最多只有一条非空 (见 Reserve / AddShape)，所以两者的先后无关
+    void FlushBatch() {
+        FlushVertices();
+        FlushShapes();
+    }
+
+    void FlushVertices() {
+        if (batch.Empty()) return;
+        shader.use();
+        batch.Flush(frameStats);
+    }
+
+    void FlushShapes() {
+        if (shapeInstances.empty()) return;
+        // 边缘的覆盖率写在 alpha 中
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        SubmitInstances(shapeQuad, shapeInstances, shapeShader);
+        glDisable(GL_BLEND);
+        shapeInstances.clear();
+    }
+
+	// 重建墙壁掩码并与纹理中的内容比较，只上传不同的格子所在的矩形 (尺寸改变时整张重建)
+    void UpdateMazeTexture(const MazeGrid& grid, uint32_t epoch) {
+        BuildMazeWallMasks(grid, mazeMaskScratch);
+        glBindTexture(GL_TEXTURE_2D, mazeTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        if (grid.width != mazeTextureWidth || grid.height != mazeTextureHeight) {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, grid.width, grid.height, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, mazeMaskScratch.data());
+            frameStats.bytesUploaded += mazeMaskScratch.size();
+            mazeTextureWidth = grid.width;
+            mazeTextureHeight = grid.height;
+        }
+        else {
+            int x0, y0, x1, y1;
+            if (FindDirtyRect(mazeMasks, mazeMaskScratch, grid.width, grid.height, x0, y0, x1, y1)) {
+                glPixelStorei(GL_UNPACK_ROW_LENGTH, grid.width);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, x1 - x0, y1 - y0, GL_RED_INTEGER, GL_UNSIGNED_BYTE,
+                    mazeMaskScratch.data() + static_cast<size_t>(y0) * grid.width + x0);
+                glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+                frameStats.bytesUploaded += static_cast<size_t>(x1 - x0) * (y1 - y0);
+            }
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        mazeMasks.swap(mazeMaskScratch);
+        mazeTextureEpoch = epoch;
+    }
+
+	// 建立实例化图形: 位置 0 为单位网格顶点，位置 1-3 为每实例的中心、大小和颜色
+    void CreateInstancedShape(InstancedShape& shape, const float* vertices, int vertexCount, const unsigned int* indices, int indexCount, int floatsPerInstance = 6) {
+        shape.vertexCount = vertexCount;
+        shape.indexCount = indexCount;
+        shape.floatsPerInstance = floatsPerInstance;
+        const GLsizei stride = floatsPerInstance * sizeof(float);
+        glGenVertexArrays(1, &shape.VAO);
+        glGenBuffers(1, &shape.meshVBO);
+        glGenBuffers(1, &shape.instanceVBO);
+        glBindVertexArray(shape.VAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, shape.meshVBO);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * 2 * sizeof(float), vertices, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, shape.instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STREAM_DRAW);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        glVertexAttribDivisor(1, 1);
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride, (void*)(2 * sizeof(float)));
+        glVertexAttribDivisor(2, 1);
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+        glVertexAttribDivisor(3, 1);
+        if (floatsPerInstance > 6) { // 距离场图形的形状编号
+            glEnableVertexAttribArray(4);
+            glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+            glVertexAttribDivisor(4, 1);
+        }
+
+        if (indexCount > 0) {
+            glGenBuffers(1, &shape.EBO);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shape.EBO); // 索引缓冲绑定记录在 VAO 中
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+        }
         glBindVertexArray(0);
-        glDeleteBuffers(1, &EBO);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
-	// 绘制三角形
-    void DrawTriangle(float cx, float cy, float r, float red, float green, float blue) {
-        glBindVertexArray(VAO);
-        float vertices[] = {
-            cx, cy + r * 0.8f, red, green, blue, // Top
-            cx - r * 0.7f, cy - r * 0.4f, red, green, blue, // Bottom Left
-            cx + r * 0.7f, cy - r * 0.4f, red, green, blue  // Bottom Right
-        };
-
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_DYNAMIC_DRAW);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
+	// 先画完批处理中的图元，再画这组实例
+    void DrawInstanced(InstancedShape& shape, const std::vector<float>& instances, Shader& program) {
+        if (instances.empty()) return;
+        FlushBatch();
+        SubmitInstances(shape, instances, program);
+    }
+
+	// 上传实例数据并用一次 draw call 画出所有实例
+    void SubmitInstances(InstancedShape& shape, const std::vector<float>& instances, Shader& program) {
+        GLsizei instanceCount = static_cast<GLsizei>(instances.size() / shape.floatsPerInstance);
+        if (instanceCount == 0) return;
+        program.use();
+        glBindVertexArray(shape.VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, shape.instanceVBO);
+        // 先丢弃旧的存储再写入，驱动不必等待上一帧对它的读取
+        glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(float), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(float), instances.data());
+        if (shape.indexCount > 0) glDrawElementsInstanced(GL_TRIANGLES, shape.indexCount, GL_UNSIGNED_INT, 0, instanceCount);
+        else glDrawArraysInstanced(GL_TRIANGLES, 0, shape.vertexCount, instanceCount);
+        ++frameStats.drawCalls;
+        frameStats.vertices += static_cast<size_t>(shape.indexCount > 0 ? shape.indexCount : shape.vertexCount) * instanceCount;
+        frameStats.bytesUploaded += instances.size() * sizeof(float);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindVertexArray(0);
+        shader.use();
     }
 };
\ No newline at end of file
@@ -22,6 +22,10 @@ public:
 	void use(); // 激活着色器程序
 
 	void setMat4(const std::string& name, const glm::mat4& mat) const; // 设置4x4矩阵统一变量
+	void setInt(const std::string& name, int value) const; // 设置整数统一变量 (包括采样器的纹理单元)
+	void setFloat(const std::string& name, float value) const; // 设置浮点统一变量
+	void setVec2(const std::string& name, const glm::vec2& value) const; // 设置二维向量统一变量
+	void setVec3(const std::string& name, const glm::vec3& value) const; // 设置三维向量统一变量
 
 private:
 	void checkCompileErrors(unsigned int shader, std::string type); // 检查编译和链接错误
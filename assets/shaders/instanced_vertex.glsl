@@ -0,0 +1,15 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aOffset;
+layout (location = 2) in float aSize;
+layout (location = 3) in vec3 aColor;
+
+out vec3 ourColor;
+
+uniform mat4 projection;
+
+void main()
+{
+    gl_Position = projection * vec4(aOffset + aPos * aSize, 0.0, 1.0);
+    ourColor = aColor;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#version 330 core
+in vec2 worldPos;
+out vec4 FragColor;
+
+uniform usampler2D walls;
+uniform float cellSize;
+uniform vec3 wallColor;
+
+void main()
+{
+    ivec2 size = textureSize(walls, 0);
+    vec2 cellPos = worldPos / cellSize;
+    ivec2 cell = clamp(ivec2(floor(cellPos)), ivec2(0), size - 1);
+    uint mask = texelFetch(walls, cell, 0).r;
+    vec2 local = worldPos - vec2(cell) * cellSize;
+    vec2 halfWidth = 0.5 * fwidth(worldPos);
+    bool wall = ((mask & 1u) != 0u && abs(local.y) <= halfWidth.y)
+             || ((mask & 2u) != 0u && abs(local.x - cellSize) <= halfWidth.x)
+             || ((mask & 4u) != 0u && abs(local.y - cellSize) <= halfWidth.y)
+             || ((mask & 8u) != 0u && abs(local.x) <= halfWidth.x);
+    if (!wall) discard;
+    FragColor = vec4(wallColor, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+
+out vec2 worldPos;
+
+uniform mat4 projection;
+uniform vec2 mazeExtent;
+
+void main()
+{
+    worldPos = mix(vec2(-1.0), mazeExtent + vec2(1.0), aPos);
+    gl_Position = projection * vec4(worldPos, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#version 330 core
+in vec2 localPos;
+in vec3 ourColor;
+flat in int shapeType;
+out vec4 FragColor;
+
+float sdTriangle(vec2 p, vec2 p0, vec2 p1, vec2 p2)
+{
+    vec2 e0 = p1 - p0, e1 = p2 - p1, e2 = p0 - p2;
+    vec2 v0 = p - p0, v1 = p - p1, v2 = p - p2;
+    vec2 pq0 = v0 - e0 * clamp(dot(v0, e0) / dot(e0, e0), 0.0, 1.0);
+    vec2 pq1 = v1 - e1 * clamp(dot(v1, e1) / dot(e1, e1), 0.0, 1.0);
+    vec2 pq2 = v2 - e2 * clamp(dot(v2, e2) / dot(e2, e2), 0.0, 1.0);
+    float s = sign(e0.x * e2.y - e0.y * e2.x);
+    vec2 d = min(min(vec2(dot(pq0, pq0), s * (v0.x * e0.y - v0.y * e0.x)),
+                     vec2(dot(pq1, pq1), s * (v1.x * e1.y - v1.y * e1.x))),
+                     vec2(dot(pq2, pq2), s * (v2.x * e2.y - v2.y * e2.x)));
+    return -sqrt(d.x) * sign(d.y);
+}
+
+void main()
+{
+    float d;
+    if (shapeType == 0) {
+        d = length(localPos) - 1.0;
+    } else if (shapeType == 1) {
+        vec2 q = abs(localPos) - vec2(1.0);
+        d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0);
+    } else {
+        d = sdTriangle(localPos, vec2(0.0, 0.8), vec2(-0.7, -0.4), vec2(0.7, -0.4));
+    }
+    float alpha = clamp(0.5 - d / fwidth(d), 0.0, 1.0);
+    if (alpha <= 0.0) discard;
+    FragColor = vec4(ourColor, alpha);
+}
\ No newline at end of file
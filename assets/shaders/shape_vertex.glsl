@@ -0,0 +1,21 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aOffset;
+layout (location = 2) in float aSize;
+layout (location = 3) in vec3 aColor;
+layout (location = 4) in float aShape;
+
+out vec2 localPos;
+out vec3 ourColor;
+flat out int shapeType;
+
+uniform mat4 projection;
+
+void main()
+{
+    float extent = aSize + 1.0;
+    localPos = aPos * (extent / aSize);
+    gl_Position = projection * vec4(aOffset + aPos * extent, 0.0, 1.0);
+    ourColor = aColor;
+    shapeType = int(aShape + 0.5);
+}
\ No newline at end of file
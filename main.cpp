@@ -6,18 +6,28 @@
 #include <vector>
 #include <cstdlib>
 #include <ctime>
+#include <string>
+#include <chrono>
+#include <random>
 
 #include "Shader.h"
 #include "MazeGenerator.h"
 #include "Player.h" // 包含 Player 头文件
 #include "Monster.h" // 包含 Monster 头文件
+#include "MonsterUpdater.h"
+#include "AiLodScheduler.h"
+#include "PathService.h"
 #include "Collectible.h"
+#include "Level.h"
+#include "FrameTimeProbe.h"
 #include "Renderer.h"
 #include "AudioSystem.h"
+#include "Benchmark.h"
 
 // 全局变量用于回调
 bool keys[1024]; // 按键状态
 bool alertTriggered = false; // 警报状态
+bool showAiStats = false; // F3: 每秒在控制台输出 AI LOD 各档的怪物数、路径缓存与渲染统计
 AudioSystem audioSystem; // 全局音频系统实例
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height); // 窗口大小回调
@@ -25,8 +35,11 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods); // 鼠标按钮回调
 
 // --- 新增: 重置游戏函数 ---
-void ResetGame(MazeGenerator& mazeGen, Player& player, std::vector<Monster>& monsters, std::vector<Collectible>& collectibles, int& score, const int MAZE_WIDTH, const int MAZE_HEIGHT, const float CELL_SIZE) {
-    mazeGen.Generate();
+// 下一关已在后台生成好 (见 LevelBuilder)，这里只交换数据，不在渲染线程上生成迷宫
+void ResetGame(std::unique_ptr<Level> level, MazeGenerator& mazeGen, Player& player, std::vector<Monster>& monsters, std::vector<Collectible>& collectibles, int& score, const float CELL_SIZE) {
+    std::swap(mazeGen, level->mazeGen);
+    monsters.swap(level->monsters);
+    collectibles.swap(level->collectibles);
 
     // --- 修改 Player 初始化 ---
     player = Player(0, 0, CELL_SIZE); // 从 (0,0) 单元格开始
@@ -37,26 +50,17 @@ void ResetGame(MazeGenerator& mazeGen, Player& player, std::vector<Monster>& mon
     player.cooldownE = 0.0f;
     player.cooldownQ = 0.0f;
 
-    monsters.clear();
-    monsters.emplace_back(5 * CELL_SIZE + CELL_SIZE / 2, 5 * CELL_SIZE + CELL_SIZE / 2);
-    monsters.emplace_back(10 * CELL_SIZE + CELL_SIZE / 2, 10 * CELL_SIZE + CELL_SIZE / 2);
-    monsters.emplace_back(15 * CELL_SIZE + CELL_SIZE / 2, 15 * CELL_SIZE + CELL_SIZE / 2);
-	monsters.emplace_back(20 * CELL_SIZE + CELL_SIZE / 2, 15 * CELL_SIZE + CELL_SIZE / 2);
-	monsters.emplace_back(18 * CELL_SIZE + CELL_SIZE / 2, 18 * CELL_SIZE + CELL_SIZE / 2);
-
-    collectibles.clear();
-    for (int i = 0; i < 5; ++i) {
-        int x = rand() % MAZE_WIDTH;
-        int y = rand() % MAZE_HEIGHT;
-        collectibles.emplace_back(x * CELL_SIZE + CELL_SIZE / 2, y * CELL_SIZE + CELL_SIZE / 2);
-    }
-
     score = collectibles.size();
     alertTriggered = false;
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    // 性能测试模式: 不打开窗口
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        return RunBenchmarks(argc, argv);
+    }
+
     srand(static_cast<unsigned int>(time(0)));
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -93,27 +97,27 @@ int main()
     const int MAZE_WIDTH = 20;
     const int MAZE_HEIGHT = 20;
     const float CELL_SIZE = 25.0f;
-    MazeGenerator mazeGen(MAZE_WIDTH, MAZE_HEIGHT);
-    mazeGen.Generate();
+    // 第一关同步生成，之后的关卡都在胜利画面期间后台生成
+    std::unique_ptr<Level> firstLevel = BuildLevel(MAZE_WIDTH, MAZE_HEIGHT, CELL_SIZE, std::random_device{}());
+    MazeGenerator mazeGen = std::move(firstLevel->mazeGen);
+    std::vector<Monster> monsters = std::move(firstLevel->monsters);
+    std::vector<Collectible> collectibles = std::move(firstLevel->collectibles);
+    firstLevel.reset();
 
     // 简单放置玩家在起点
     Player player(0, 0, CELL_SIZE);
 
-    // 放置怪物
-    std::vector<Monster> monsters;
-    monsters.emplace_back(5 * CELL_SIZE + CELL_SIZE / 2, 5 * CELL_SIZE + CELL_SIZE / 2);
-    monsters.emplace_back(10 * CELL_SIZE + CELL_SIZE / 2, 10 * CELL_SIZE + CELL_SIZE / 2);
-    monsters.emplace_back(15 * CELL_SIZE + CELL_SIZE / 2, 15 * CELL_SIZE + CELL_SIZE / 2);
-    monsters.emplace_back(20 * CELL_SIZE + CELL_SIZE / 2, 15 * CELL_SIZE + CELL_SIZE / 2);
-    monsters.emplace_back(18 * CELL_SIZE + CELL_SIZE / 2, 18 * CELL_SIZE + CELL_SIZE / 2);
-
-    // 放置收集品
-    std::vector<Collectible> collectibles;
-    for (int i = 0; i < 5; ++i) {
-        int x = rand() % MAZE_WIDTH;
-        int y = rand() % MAZE_HEIGHT;
-        collectibles.emplace_back(x * CELL_SIZE + CELL_SIZE / 2, y * CELL_SIZE + CELL_SIZE / 2);
-    }
+    LevelBuilder levelBuilder;
+    FlowField chaseField; // 所有怪物共用的朝向玩家的流场
+    FrameTimeProbe frameProbe;
+    JobSystem jobSystem;
+    MonsterUpdater monsterUpdater(jobSystem);
+    AiLodScheduler aiLod; // 远处的怪物降频或休眠
+    PathService pathService; // 怪物的寻路请求在之后几帧的时间片内完成
+    PathCache pathCache;     // 所有怪物共用，迷宫纪元改变时自动清空
+    pathService.SetCache(&pathCache);
+    const double PATH_BUDGET_SECONDS = 0.001;
+    float aiStatsTimer = 0.0f;
 
     Renderer renderer(SCR_WIDTH, SCR_HEIGHT);
 
@@ -131,6 +135,7 @@ int main()
         float currentFrame = glfwGetTime();
         float deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
+        frameProbe.Record(deltaTime);
 
         // --- 修改输入处理和移动逻辑 ---
         // 不再直接根据 WASD 计算连续的 newPosition
@@ -185,15 +190,36 @@ int main()
 
         // --- Monster 和 Collectible 逻辑 (基本保持不变) ---
         alertTriggered = false;
-        for (auto& monster : monsters) {
-            monster.Update(deltaTime, player, mazeGen, CELL_SIZE);
-            if (!alertTriggered && monster.visible && glm::distance(monster.position, player.position) < monster.detectionRange) {
+        chaseField.Update(mazeGen.maze, player.cellX, player.cellY); // 玩家换格时才重建
+        // 怪物按 AI LOD 分档后在任务系统上并行更新，警报/碰撞等副作用合并成事件列表后在这里按顺序处理
+        aiLod.Schedule(monsters, player, deltaTime);
+        monsterUpdater.Update(monsters, aiLod, player, mazeGen, CELL_SIZE, &chaseField, player.cooldownQ <= (20.0f - 2.0f + 0.1f));
+        for (size_t i = 0; i < monsters.size(); ++i) {
+            monsters[i].RequestPath(pathService, static_cast<uint32_t>(i), mazeGen, CELL_SIZE);
+        }
+        pathService.Service(mazeGen, PATH_BUDGET_SECONDS);
+        for (const PathResult& result : pathService.Results()) {
+            monsters[result.requester].ReceivePath(result, mazeGen, CELL_SIZE);
+        }
+        if (showAiStats && (aiStatsTimer += deltaTime) >= 1.0f) {
+            aiStatsTimer = 0.0f;
+            const AiLodScheduler::Stats& lod = aiLod.LastStats();
+            std::cout << "[ai lod] near " << lod.updated[AiLodScheduler::TIER_NEAR] << "/" << lod.inTier[AiLodScheduler::TIER_NEAR]
+                      << "  mid " << lod.updated[AiLodScheduler::TIER_MID] << "/" << lod.inTier[AiLodScheduler::TIER_MID]
+                      << "  far " << lod.updated[AiLodScheduler::TIER_FAR] << "/" << lod.inTier[AiLodScheduler::TIER_FAR]
+                      << "  sleeping " << lod.inTier[AiLodScheduler::TIER_SLEEP] << "  deferred " << lod.deferred << "\n";
+            const PathCache::Stats& cacheStats = pathCache.GetStats();
+            std::cout << "[path cache] hits " << cacheStats.hits << "  suffix hits " << cacheStats.suffixHits << "  misses " << cacheStats.misses
+                      << "  evictions " << cacheStats.evictions << "  " << pathCache.EntryCount() << " paths / " << pathCache.CellCount() << " cells\n";
+            const RenderBatch::Stats& render = renderer.LastFrameStats();
+            std::cout << "[render] draw calls " << render.drawCalls << "  vertices " << render.vertices
+                      << "  uploaded " << render.bytesUploaded / 1024 << " KB/frame\n";
+        }
+        for (const MonsterEvent& event : monsterUpdater.Events()) {
+            if (event.type == MonsterEvent::ALERT && !alertTriggered) {
                 alertTriggered = true;
                 audioSystem.PlaySound("alert");
             }
-            if (monster.frozen && player.cooldownQ <= (20.0f - 2.0f + 0.1f)) {
-                monster.frozen = false;
-            }
         }
 
         for (auto& item : collectibles) {
@@ -211,15 +237,10 @@ int main()
 
         // --- 玩家与怪物碰撞检测 ---
         bool playerHit = false;
-        for (const auto& monster : monsters) {
-            if (!monster.frozen) { // 冻结状态下不造成伤害
-                float dx = player.position.x - monster.position.x;
-                float dy = player.position.y - monster.position.y;
-                float dist = sqrt(dx * dx + dy * dy);
-                if (dist < (player.radius + monster.radius)) {
-                    playerHit = true;
-                    break;
-                }
+        for (const MonsterEvent& event : monsterUpdater.Events()) {
+            if (event.type == MonsterEvent::CONTACT) { // 冻结的怪物不会产生该事件
+                playerHit = true;
+                break;
             }
         }
 
@@ -238,13 +259,20 @@ int main()
             gameWon = true;
             victoryTimer = 0.0f;
             std::cout << "Victory! Game will restart shortly...\n";
+            levelBuilder.Start(MAZE_WIDTH, MAZE_HEIGHT, CELL_SIZE, std::random_device{}());
         }
 
         // --- 胜利状态处理 ---
         if (gameWon) {
             victoryTimer += deltaTime;
-            if (victoryTimer >= victoryDisplayTime) {
-                ResetGame(mazeGen, player, monsters, collectibles, score, MAZE_WIDTH, MAZE_HEIGHT, CELL_SIZE);
+            // 下一关生成完成后才切换 (通常远早于胜利画面结束)
+            if (victoryTimer >= victoryDisplayTime && levelBuilder.IsReady()) {
+                auto swapStart = std::chrono::steady_clock::now();
+                ResetGame(levelBuilder.Take(), mazeGen, player, monsters, collectibles, score, CELL_SIZE);
+                chaseField.Invalidate();
+                aiLod.Reset();
+                pathService.Reset();
+                frameProbe.Mark("level swap", std::chrono::duration<double>(std::chrono::steady_clock::now() - swapStart).count());
                 gameWon = false;
                 victoryTimer = 0.0f;
             }
@@ -283,6 +311,8 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 {
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS)
+        showAiStats = !showAiStats;
     if (key >= 0 && key < 1024)
     {
         if (action == GLFW_PRESS)